@@ -0,0 +1,305 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <limits>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+/*
+ * The type of the path costs and A* keys of a search: the type the heuristic returns,
+ * which is the scalar type of the geometry.
+ */
+template <typename Heuristic>
+using SearchCost = typename std::decay<decltype(std::declval<Heuristic&>()(0))>::type;
+
+/*
+ * Reconstruct the path from the A* algorithm result.
+ *
+ * @param cameFrom - The previous node of each node on its best known path, -1 if none.
+ * @param current - The current node being processed.
+ *
+ * @return A vector of node ids representing the reconstructed path.
+ */
+inline std::vector<int> reconstructPath(const std::vector<int>& cameFrom, int current) {
+    std::vector<int> totalPath;
+    totalPath.push_back(current);
+
+    while (cameFrom[current] != -1) {
+        current = cameFrom[current];
+        totalPath.push_back(current);
+    }
+
+    std::reverse(totalPath.begin(), totalPath.end());
+    return totalPath;
+}
+
+/*
+ * Implementation of the A* algorithm to find the shortest route between start and goal nodes.
+ *
+ * The graph must provide getNumVertices() and forEachNeighbor(node, visit), which calls
+ * visit(neighbor, distance) for every neighbor of the node.
+ *
+ * @param graph - The graph to search.
+ * @param start - The starting node id.
+ * @param goal - The goal node id.
+ * @param heuristic - Estimate of the distance from a node to the goal, must not overestimate.
+ *
+ * @return A vector of node ids representing the shortest path, empty if there is none.
+ */
+template <typename Graph, typename Heuristic>
+std::vector<int> aStar(const Graph& graph, int start, int goal, Heuristic heuristic)
+{
+    typedef SearchCost<Heuristic> Cost;
+    int numVertices = graph.getNumVertices();
+
+    std::priority_queue<std::pair<Cost, int>, std::vector<std::pair<Cost, int>>, std::greater<>> openSet;
+    std::vector<Cost> gScore(numVertices, std::numeric_limits<Cost>::infinity());
+    std::vector<int> cameFrom(numVertices, -1);
+    std::vector<char> processedPoints(numVertices, false);
+
+    gScore[start] = 0;
+
+    openSet.push({ heuristic(start), start });
+
+    while (!openSet.empty()) {
+        int current = openSet.top().second;
+        openSet.pop();
+
+        // Skip if the node is already processed
+        if (processedPoints[current]) {
+            continue;
+        }
+
+        processedPoints[current] = true;
+
+        if (current == goal) {
+            return reconstructPath(cameFrom, current);
+        }
+
+        graph.forEachNeighbor(current, [&](int neighbor, Cost distanceToNeighbor) {
+            Cost tentativeGScore = gScore[current] + distanceToNeighbor;
+
+            if (tentativeGScore < gScore[neighbor]) {
+                cameFrom[neighbor] = current;
+                gScore[neighbor] = tentativeGScore;
+                Cost fScore = tentativeGScore + heuristic(neighbor);
+
+                openSet.push({ fScore, neighbor });
+            }
+        });
+    }
+
+    std::vector<int> result;
+    return result;
+}
+
+/*
+ * Anytime Repairing A* (ARA*): a weighted A* whose weight epsilon decreases from round
+ * to round, each round reusing the search state of the previous one.
+ *
+ * The first round quickly finds a path at most epsilon times longer than the shortest
+ * one. Every later round lowers epsilon and repairs the search tree instead of starting
+ * over: only the nodes whose cost improved are expanded again. After each round the path
+ * and its suboptimality bound are updated, and search() stops when the deadline passes
+ * or the path is proven optimal. A round cut short by the deadline is resumed by the
+ * next call to search().
+ *
+ * The graph is the same as for aStar(). The heuristic must not overestimate.
+ */
+template <typename Graph, typename Heuristic>
+class AnytimeAStar {
+private:
+    typedef SearchCost<Heuristic> Cost;
+
+    const Graph& graph;
+    int start, goal;
+    Heuristic heuristic;
+    double epsilon, epsilonStep;
+
+    // Search state kept between rounds
+    std::vector<Cost> gScore, hScore;
+    std::vector<int> cameFrom;
+    std::vector<char> inOpenSet, processedPoints, inconsistent;
+    std::vector<int> inconsistentPoints;
+    std::priority_queue<std::pair<Cost, int>, std::vector<std::pair<Cost, int>>, std::greater<>> openSet;
+    bool roundFinished;
+
+    // Best path so far and its suboptimality bound
+    std::vector<int> path;
+    double bound;
+
+    Cost key(int node) const
+    {
+        return gScore[node] + (Cost)epsilon * hScore[node];
+    }
+
+    // Expand nodes until the goal is reached at the current epsilon, false if the deadline passed first
+    template <typename TimePoint>
+    bool improvePath(TimePoint deadline)
+    {
+        int expansions = 0;
+        while (!openSet.empty()) {
+            int current = openSet.top().second;
+
+            // Skip entries of nodes that left the open set or got a better key since
+            if (!inOpenSet[current] || openSet.top().first != key(current)) {
+                openSet.pop();
+                continue;
+            }
+
+            if (gScore[goal] <= openSet.top().first) {
+                break;
+            }
+
+            if (++expansions % 64 == 0 && TimePoint::clock::now() >= deadline) {
+                return false;
+            }
+
+            openSet.pop();
+            inOpenSet[current] = false;
+            processedPoints[current] = true;
+
+            graph.forEachNeighbor(current, [&](int neighbor, Cost distanceToNeighbor) {
+                Cost tentativeGScore = gScore[current] + distanceToNeighbor;
+
+                if (tentativeGScore < gScore[neighbor]) {
+                    cameFrom[neighbor] = current;
+                    gScore[neighbor] = tentativeGScore;
+                    if (hScore[neighbor] < 0) {
+                        hScore[neighbor] = heuristic(neighbor);
+                    }
+
+                    if (!processedPoints[neighbor]) {
+                        inOpenSet[neighbor] = true;
+                        openSet.push({ key(neighbor), neighbor });
+                    }
+                    else if (!inconsistent[neighbor]) {
+                        // Already expanded in this round, revisit it in the next one
+                        inconsistent[neighbor] = true;
+                        inconsistentPoints.push_back(neighbor);
+                    }
+                }
+            });
+        }
+        return true;
+    }
+
+    // Publish the path of the finished round and compute its bound
+    void publish()
+    {
+        if (gScore[goal] == std::numeric_limits<Cost>::infinity()) {
+            path.clear();
+            bound = std::numeric_limits<double>::infinity();
+            return;
+        }
+
+        path = reconstructPath(cameFrom, goal);
+
+        // No node left to expand can lead to a path shorter than this lower bound
+        Cost lowerBound = gScore[goal];
+        for (int node = 0; node < (int)inOpenSet.size(); node++) {
+            if (inOpenSet[node] || inconsistent[node]) {
+                lowerBound = std::min(lowerBound, gScore[node] + hScore[node]);
+            }
+        }
+        bound = (lowerBound > 0) ? std::min(epsilon, (double)gScore[goal] / lowerBound) : 1.0;
+    }
+
+    // Lower epsilon and move the inconsistent nodes back to the open set for the next round
+    void startRound()
+    {
+        epsilon = std::max(1.0, std::min(epsilon - epsilonStep, bound));
+
+        for (int node : inconsistentPoints) {
+            inconsistent[node] = false;
+            inOpenSet[node] = true;
+        }
+        inconsistentPoints.clear();
+        std::fill(processedPoints.begin(), processedPoints.end(), false);
+
+        // The keys depend on epsilon, so the open set is rebuilt
+        openSet = decltype(openSet)();
+        for (int node = 0; node < (int)inOpenSet.size(); node++) {
+            if (inOpenSet[node]) {
+                openSet.push({ key(node), node });
+            }
+        }
+    }
+
+public:
+    /*
+     * Prepare a search. No node is expanded before search() is called.
+     *
+     * @param graph - The graph to search.
+     * @param start - The starting node id.
+     * @param goal - The goal node id.
+     * @param heuristic - Estimate of the distance from a node to the goal, must not overestimate.
+     * @param initialEpsilon - The weight of the heuristic in the first round, at least 1.
+     * @param epsilonStep - How much the weight decreases after each round.
+     */
+    AnytimeAStar(const Graph& graph, int start, int goal, Heuristic heuristic, double initialEpsilon, double epsilonStep)
+        : graph(graph), start(start), goal(goal), heuristic(heuristic),
+        epsilon(std::max(1.0, initialEpsilon)), epsilonStep(epsilonStep),
+        roundFinished(false), bound(std::numeric_limits<double>::infinity())
+    {
+        int numVertices = graph.getNumVertices();
+        gScore.assign(numVertices, std::numeric_limits<Cost>::infinity());
+        hScore.assign(numVertices, -1);
+        cameFrom.assign(numVertices, -1);
+        inOpenSet.assign(numVertices, false);
+        processedPoints.assign(numVertices, false);
+        inconsistent.assign(numVertices, false);
+
+        gScore[start] = 0;
+        hScore[start] = heuristic(start);
+        hScore[goal] = 0;
+        inOpenSet[start] = true;
+        openSet.push({ key(start), start });
+    }
+
+    /*
+     * Search until the deadline, improving the path round after round. The first round
+     * always runs to completion, so a path is found whenever one exists.
+     *
+     * @param deadline - The time at which the search stops, a std::chrono time point.
+     *
+     * @return True if the path is proven optimal, false if the deadline cut the search short.
+     */
+    template <typename TimePoint>
+    bool search(TimePoint deadline)
+    {
+        if (path.empty() && !roundFinished) {
+            improvePath(TimePoint::max());
+            roundFinished = true;
+            publish();
+        }
+
+        while (!path.empty() && bound > 1.0) {
+            if (roundFinished) {
+                startRound();
+                roundFinished = false;
+            }
+            if (!improvePath(deadline)) {
+                return false;
+            }
+            roundFinished = true;
+            publish();
+        }
+
+        return true;
+    }
+
+    // Get the best path found so far, empty if there is none
+    const std::vector<int>& getPath() const
+    {
+        return path;
+    }
+
+    // Get the suboptimality bound of the path: it is at most this many times longer than the shortest one
+    double getBound() const
+    {
+        return bound;
+    }
+};
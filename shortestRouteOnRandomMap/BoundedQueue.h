@@ -0,0 +1,58 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/*
+ * A blocking queue with a fixed capacity, used to pass work between pipeline stages.
+ *
+ * push() waits while the queue is full, so a fast producer cannot run ahead of the
+ * consumers and memory stays bounded. pop() waits while the queue is empty. Once the
+ * producers call close(), pop() drains the remaining items and then returns false.
+ */
+template <typename T>
+class BoundedQueue {
+private:
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+
+public:
+    // Constructor
+    explicit BoundedQueue(size_t capacity) : capacity(capacity), closed(false) {
+    }
+
+    // Add an item, waiting while the queue is full
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return items.size() < capacity; });
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+    }
+
+    // Remove the oldest item, waiting while the queue is empty. Returns false once the queue is closed and empty
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return !items.empty() || closed; });
+        if (items.empty())
+        {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // Signal that no more items will be pushed
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+    }
+};
@@ -1,23 +1,25 @@
 #include "ControlManager.h"
 #include "Point.h"
+#include "Predicates.h"
+#include "AStar.h"
+#include "BoundedQueue.h"
+#include "KShortestPaths.h"
 #include <fstream>
 #include <iostream>
 #include <stdlib.h>
 #include <vector>
 #include <algorithm>
 #include <cmath>
-#include <stack>
 #include <fstream>
-#include <unordered_map>
-#include <unordered_set>
-#include <map>
 #include <limits>
-#include <queue>
-#include <functional>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 
 // Constructor implementation
-ControlManager::ControlManager() : mapSize(0), numPolygons(0), startPoint(Point(0,0)), endPoint(Point(mapSize,mapSize)) {
+ControlManager::ControlManager() : mapSize(0), numPolygons(0), engine(Engine::VisibilityGraph), smoothing(false), reordered(false), matrixEnabled(true), usingMatrix(false), hasDeadline(false), pathBound(1.0), writePathFile(true) {
 }
 
 /*
@@ -38,6 +40,63 @@ void ControlManager::setPath(const std::vector<Point>& newPath) {
     path = newPath;
 }
 
+/*
+ * Select the engine used by findShortestRoute().
+ *
+ * @param newEngine - The visibility graph, or the navigation mesh.
+ */
+void ControlManager::setEngine(Engine newEngine) {
+    engine = newEngine;
+}
+
+/*
+ * Set the time by which the route must be found. The visibility graph engine then
+ * returns a route that may be longer than the shortest one, with its suboptimality bound.
+ *
+ * @param newDeadline - The time by which findShortestRoute() should return.
+ */
+void ControlManager::setDeadline(std::chrono::steady_clock::time_point newDeadline) {
+    deadline = newDeadline;
+    hasDeadline = true;
+}
+
+/*
+ * Getter for the suboptimality bound of the path.
+ *
+ * @return The factor by which the path may be longer than the shortest route, 1 if it is the shortest.
+ */
+double ControlManager::getPathBound() const {
+    return pathBound;
+}
+
+/*
+ * Enable writing the path to shortest_path.txt.
+ *
+ * @param enabled - True to write the file, false to only keep the path in memory.
+ */
+void ControlManager::setPathFileOutput(bool enabled) {
+    writePathFile = enabled;
+}
+
+/*
+ * Enable shortening the path found on the occupancy grid against the exact convex hulls.
+ *
+ * @param enabled - True to smooth the path, false to keep the path found on the grid.
+ */
+void ControlManager::setSmoothing(bool enabled) {
+    smoothing = enabled;
+}
+
+/*
+ * Enable the bit-packed line of sight matrix, used instead of the adjacency arrays
+ * for maps with at most VisibilityMatrix::MAX_VERTICES vertices.
+ *
+ * @param enabled - True to use the matrix when the map is small enough.
+ */
+void ControlManager::setVisibilityMatrix(bool enabled) {
+    matrixEnabled = enabled;
+}
+
  /*
  * Write data to a text file.
  */
@@ -46,17 +105,19 @@ void ControlManager::writeData()
     // Create and open a text file
     std::ofstream writeFile("writeFile.txt");
 
-    // Iterate over polygons and write their data to the file
+    // Iterate over polygons in input order and write their data to the file
     for (int polygonNumber = 0; polygonNumber < numPolygons; polygonNumber++)
     {
-        int pointsNumber = polygons[polygonNumber].getPolygonsPointsArray().size();
+        Polygon polygon = store.getPolygon(store.getRankedPolygon(polygonNumber));
+        int pointsNumber = polygon.getNumPoints();
         writeFile << polygonNumber << "\n" << pointsNumber << "\n";
 
         // Write each point's coordinates to the file
         for (int j = 0; j < pointsNumber; j++)
         {
-            writeFile << polygons[polygonNumber].getPolygonsPointsArray()[j].getX() << " ";
-            writeFile << polygons[polygonNumber].getPolygonsPointsArray()[j].getY() << "\n";
+            int vertex = polygon.getVertexId(j);
+            writeFile << store.getX(vertex) << " ";
+            writeFile << store.getY(vertex) << "\n";
         }
 
         writeFile << "\n";
@@ -66,45 +127,86 @@ void ControlManager::writeData()
 }
 
 /*
- * Read data from a text file.
+ * Estimate the number of points in a map file from its size, so the store can reserve
+ * its arrays once. A point takes at least one short line of text.
+ *
+ * @param file - The open map file, its read position is kept.
+ *
+ * @return An upper estimate of the number of points.
+ */
+int estimatePointCount(std::ifstream& file)
+{
+    std::streampos position = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg() - position;
+    file.seekg(position);
+
+    // A point line such as "12.5 7.25" is rarely shorter than 12 bytes
+    return (int)std::min<std::streamoff>(size / 12, std::numeric_limits<int>::max() - 2);
+}
+
+/*
+ * Read data from a text file. A file that cannot be opened or that holds fewer polygons
+ * or points than it declares is reported on stderr and the map is left incomplete.
  *
  * @param filename - The name of the file to read data from.
+ *
+ * @return True if the whole map was read, false otherwise.
  */
-void ControlManager:: readData(const std::string& filename)
+bool ControlManager:: readData(const std::string& filename)
 {
     std::ifstream file(filename); // Open the text file for reading
 
     if (!file.is_open())
     {
         std::cerr << "Failed to open the file." << std::endl;
-        exit(1);
+        return false;
     }
 
     file >> mapSize; // Read map size
     file >> numPolygons; // Read number of polygons
 
+    if (!file || numPolygons < 0)
+    {
+        std::cerr << "Invalid map header in " << filename << std::endl;
+        return false;
+    }
+
+    // The start and end points are the opposite corners of the map
+    store.reset(Point(0.0, 0.0), Point((double)mapSize, (double)mapSize));
+    int pointLimit = estimatePointCount(file);
+    store.reserve(std::min(numPolygons, pointLimit), pointLimit);
+
     // Iterate over polygons in the file and read their data
     for (int i = 0; i < numPolygons; ++i)
     {
         int polygonNumber, numPoints;
         file >> polygonNumber >> numPoints;
 
-        std::vector<Point> polygonPoints;
+        if (!file || numPoints < 0)
+        {
+            std::cerr << "Map file " << filename << " declares " << numPolygons << " polygons but only " << i << " could be read" << std::endl;
+            return false;
+        }
+
+        store.beginPolygon(polygonNumber);
 
-        // Read each point's coordinates and create a polygon
+        // Read each point's coordinates straight into the store
         for (int j = 0; j < numPoints; ++j) 
         {
             double x, y;
             file >> x >> y;
-            polygonPoints.emplace_back(x, y);
+            if (!file)
+            {
+                std::cerr << "Polygon " << polygonNumber << " in " << filename << " declares " << numPoints << " points but only " << j << " could be read" << std::endl;
+                return false;
+            }
+            store.addPoint(x, y);
         }
-        Polygon polygon(polygonPoints, polygonNumber);
-        polygons.push_back(polygon);
     }
-    this->startPoint = {0.0, 0.0};
-    this->endPoint = {(double)mapSize, (double)mapSize};
 
     file.close();
+    return true;
 }
 
 
@@ -112,6 +214,8 @@ void ControlManager:: readData(const std::string& filename)
 
 /*
  * Custom comparator function for sorting points based on polar angles and distances from a pivot point.
+ * The polar angles are compared with the robust orientation predicate instead of atan2,
+ * which is exact since every point lies above or to the right of the pivot.
  *
  * @param pivot - The pivot point.
  * @param p1 - The first point for comparison.
@@ -119,17 +223,14 @@ void ControlManager:: readData(const std::string& filename)
  *
  * @return True if p1 is less than p2 in terms of polar angle and distance from the pivot, false otherwise.
  */
-// Convex Hull //
-// Define a custom comparator function for sorting points based on polar angles and distances
 bool customComparator(const Point& pivot, const Point& p1, const Point& p2) {
-    double angle1 = std::atan2(p1.getY() - pivot.getY(), p1.getX() - pivot.getX());
-    double angle2 = std::atan2(p2.getY() - pivot.getY(), p2.getX() - pivot.getX());
+    int turn = orientation(pivot, p1, p2);
 
-    if (angle1 == angle2) {
+    if (turn == 0) {
         return std::hypot(p1.getX() - pivot.getX(), p1.getY() - pivot.getY()) < std::hypot(p2.getX() - pivot.getX(), p2.getY() - pivot.getY());
     }
 
-    return angle1 < angle2;
+    return turn > 0;
 }
 
 /*
@@ -169,120 +270,376 @@ void convexHull(std::vector<Point>& points)
             return customComparator(pivot, p1, p2);
         });
 
-    // Initialize the convex hull with the first two points
-    std::stack<Point> hull;
-    hull.push(points[0]);
-    hull.push(points[1]);
+    // Initialize the convex hull with the first two points.
+    // The hull is built in place at the front of the points array, used as a stack.
+    size_t hullSize = 2;
 
     // Build the convex hull
     for (size_t i = 2; i < points.size(); i++)
     {
-        Point top = hull.top();
-        hull.pop();
-        while (!hull.empty() && Point::crossProduct(hull.top(), top, points[i]) <= 0)
+        Point top = points[hullSize - 1];
+        hullSize--;
+        while (hullSize > 0 && orientation(points[hullSize - 1], top, points[i]) <= 0)
         {
-            top = hull.top();
-            hull.pop();
+            top = points[hullSize - 1];
+            hullSize--;
         }
-        hull.push(top);
-        hull.push(points[i]);
+        points[hullSize++] = top;
+        points[hullSize++] = points[i];
     }
 
     // Update the original points array with the computed convex hull
-    std::vector<Point> convexHullPoints;
-    while (!hull.empty())
-    {
-        convexHullPoints.push_back(hull.top());
-        hull.pop();
-    }
-
-    std::reverse(convexHullPoints.begin(), convexHullPoints.end());
-    points = convexHullPoints;
+    points.resize(hullSize, points[0]);
 }
 
 /*
  * Perform convex hull computation for each polygon in the ControlManager.
+ * Each hull is written back over the start of its polygon in the store,
+ * then the store is compacted in a single pass and the hulls are indexed.
  */
 void ControlManager::performConvexHull()
 {
+    std::vector<Point> points;
+    std::vector<int> hullSizes(numPolygons);
+    Scalar* xs = store.getXs();
+    Scalar* ys = store.getYs();
+
     for (int i = 0; i < this->numPolygons; i++)
     {
-        convexHull((polygons[i].getPolygonsPointsArray()));
+        int begin = store.getPolygonBegin(i);
+        int end = store.getPolygonEnd(i);
+
+        // Reuse one scratch buffer for all the polygons
+        points.clear();
+        for (int vertex = begin; vertex < end; vertex++)
+        {
+            points.emplace_back(xs[vertex], ys[vertex]);
+        }
+
+        convexHull(points);
+
+        for (size_t j = 0; j < points.size(); j++)
+        {
+            xs[begin + j] = points[j].getX();
+            ys[begin + j] = points[j].getY();
+        }
+        hullSizes[i] = points.size();
     }
+
+    store.truncatePolygons(hullSizes);
+    index.build(store);
 }
 
 
-// Line of Sight //
+// Pipelined Ingestion //
 
 /*
- * Calculate the slope between two points.
- *
- * @param p1 - The first point.
- * @param p2 - The second point.
- *
- * @return The slope between the two points.
+ * Polygons passed between the pipeline stages in batches, so the queues are locked
+ * once per batch rather than once per polygon.
  */
-double calculateSlope(const Point& p1, const Point& p2) {
-    return (p2.getY() - p1.getY()) / (p2.getX() - p1.getX());
-}
+struct PolygonBatch
+{
+    // Position of the batch in the input, batches are committed in this order
+    int sequence;
+
+    // Identifier, points and, after the hull stage, bounding box of each polygon
+    std::vector<int> numbers;
+    std::vector<std::vector<Point>> points;
+    std::vector<BoundingBox> boxes;
+};
 
 /*
- * Check if two line segments defined by points (p1, p2) and (p3, p4) are crossing.
+ * Read the map data and compute the convex hulls in a pipeline, equivalent to readData()
+ * followed by performConvexHull().
  *
- * @param p1, p2 - Points defining the first line segment.
- * @param p3, p4 - Points defining the second line segment.
+ * The calling thread reads polygons into batches while worker threads compute their
+ * hulls and bounding boxes, and a committer thread adds the finished hulls to the store
+ * and the spatial index. The stages are connected by bounded queues, so parsing overlaps
+ * with the hull computation and memory stays bounded for streamed inputs. Batches are
+ * committed in input order, so the result is the same as the sequential stages. The
+ * reader stays at most a window of batches ahead of the committer, so a slow batch
+ * cannot make the committer hold back an unbounded number of finished ones. A malformed
+ * file is reported the same way as by readData(), after the stages have drained.
  *
- * @return True if the line segments intersect, false otherwise.
+ * @param filename - The name of the file to read data from.
+ * @param numWorkers - The number of hull worker threads.
+ *
+ * @return True if the whole map was read, false otherwise.
  */
-bool areLinesCrossing(const Point& p1, const Point& p2, const Point& p3, const Point& p4)
+bool ControlManager::readDataPipelined(const std::string& filename, int numWorkers)
 {
-    double m1 = calculateSlope(p1, p2);
-    double m2 = calculateSlope(p3, p4);
+    std::ifstream file(filename); // Open the text file for reading
+
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open the file." << std::endl;
+        return false;
+    }
+
+    file >> mapSize; // Read map size
+    file >> numPolygons; // Read number of polygons
+
+    if (!file || numPolygons < 0)
+    {
+        std::cerr << "Invalid map header in " << filename << std::endl;
+        return false;
+    }
+
+    // The start and end points are the opposite corners of the map
+    store.reset(Point(0.0, 0.0), Point((double)mapSize, (double)mapSize));
+    int pointLimit = estimatePointCount(file);
+    store.reserve(std::min(numPolygons, pointLimit), pointLimit);
+    index.clear();
+
+    const int batchSize = 64;
+    numWorkers = std::max(1, numWorkers);
+    BoundedQueue<PolygonBatch> parsed(2 * numWorkers);
+    BoundedQueue<PolygonBatch> hulled(2 * numWorkers);
+
+    // Reorder window: the reader waits until the batch it issues is close to the next one to commit
+    const int window = 2 * numWorkers;
+    std::mutex progressMutex;
+    std::condition_variable progress;
+    int committedBatches = 0;
+
+    // Hull stage
+    std::vector<std::thread> workers;
+    for (int i = 0; i < numWorkers; i++)
+    {
+        workers.emplace_back([&parsed, &hulled]() {
+            PolygonBatch batch;
+            while (parsed.pop(batch))
+            {
+                batch.boxes.resize(batch.points.size());
+                for (size_t j = 0; j < batch.points.size(); j++)
+                {
+                    convexHull(batch.points[j]);
+
+                    batch.boxes[j] = BoundingBox::empty();
+                    for (const Point& point : batch.points[j])
+                    {
+                        batch.boxes[j].extend(point.getX(), point.getY());
+                    }
+                }
+                hulled.push(std::move(batch));
+            }
+        });
+    }
+
+    // Index stage: commit the batches in input order, holding back the ones that finish early
+    std::thread committer([this, &hulled, &progressMutex, &progress, &committedBatches]() {
+        std::map<int, PolygonBatch> waiting;
+        int nextSequence = 0;
+        PolygonBatch batch;
+        while (hulled.pop(batch))
+        {
+            waiting.emplace(batch.sequence, std::move(batch));
+            for (auto it = waiting.find(nextSequence); it != waiting.end(); it = waiting.find(++nextSequence))
+            {
+                const PolygonBatch& ready = it->second;
+                for (size_t j = 0; j < ready.points.size(); j++)
+                {
+                    store.beginPolygon(ready.numbers[j]);
+                    for (const Point& point : ready.points[j])
+                    {
+                        store.addPoint(point.getX(), point.getY());
+                    }
+                    index.insert(ready.boxes[j]);
+                }
+                waiting.erase(it);
+
+                std::lock_guard<std::mutex> lock(progressMutex);
+                committedBatches = nextSequence + 1;
+                progress.notify_one();
+            }
+        }
+    });
+
+    // Load stage
+    PolygonBatch batch;
+    batch.sequence = 0;
+    int numRead = 0;
+    bool pointsMissing = false;
+    for (; numRead < numPolygons; ++numRead)
+    {
+        int polygonNumber, numPoints;
+        file >> polygonNumber >> numPoints;
+        if (!file || numPoints < 0)
+        {
+            break;
+        }
 
-    // Check if the slope are equal
-    if (m1 == m2)
+        // The declared count is only trusted as far as the file can hold it
+        std::vector<Point> points;
+        points.reserve(std::min(numPoints, pointLimit));
+        for (int j = 0; j < numPoints; ++j)
+        {
+            double x, y;
+            file >> x >> y;
+            if (!file)
+            {
+                std::cerr << "Polygon " << polygonNumber << " in " << filename << " declares " << numPoints << " points but only " << j << " could be read" << std::endl;
+                break;
+            }
+            points.emplace_back(x, y);
+        }
+
+        if (!file)
+        {
+            pointsMissing = true;
+            break;
+        }
+
+        batch.numbers.push_back(polygonNumber);
+        batch.points.push_back(std::move(points));
+
+        if ((int)batch.numbers.size() == batchSize)
+        {
+            int sequence = batch.sequence;
+            {
+                std::unique_lock<std::mutex> lock(progressMutex);
+                progress.wait(lock, [&]() { return sequence < committedBatches + window; });
+            }
+            parsed.push(std::move(batch));
+            batch = PolygonBatch();
+            batch.sequence = sequence + 1;
+        }
+    }
+
+    if (!batch.numbers.empty())
+    {
+        parsed.push(std::move(batch));
+    }
+
+    file.close();
+    parsed.close();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    hulled.close();
+    committer.join();
+
+    if (pointsMissing)
     {
         return false;
     }
+    if (numRead < numPolygons)
+    {
+        std::cerr << "Map file " << filename << " declares " << numPolygons << " polygons but only " << numRead << " could be read" << std::endl;
+        return false;
+    }
+    return true;
+}
+
 
-    // Check if the 2 lines intersect in the area
-    double x_intersection = (m1 * p1.getX() - p1.getY() - m2 * p3.getX() + p3.getY()) / (m1 - m2);
-    double y_intersection = m1 * (x_intersection - p1.getX()) + p1.getY();
+// Obstacle Pruning //
 
-    // Check if the intersection point lies within the area defined by the four points.
-    return (x_intersection >= std::min(p1.getX(), p2.getX()) &&
-        x_intersection <= std::max(p1.getX(), p2.getX()) &&
-        x_intersection >= std::min(p3.getX(), p4.getX()) &&
-        x_intersection <= std::max(p3.getX(), p4.getX()) &&
-        y_intersection >= std::min(p1.getY(), p2.getY()) &&
-        y_intersection <= std::max(p1.getY(), p2.getY()) &&
-        y_intersection >= std::min(p3.getY(), p4.getY()) &&
-        y_intersection <= std::max(p3.getY(), p4.getY()));
+/*
+ * Find hull vertices that lie strictly inside another convex hull and hide them.
+ * A hidden vertex can never be part of a valid route, so it is removed from the
+ * line of sight candidates. A hull whose vertices all lie inside a single other hull is
+ * contained in it and is merged into it: its edges are no longer checked.
+ * Must be called after performConvexHull().
+ */
+void ControlManager::pruneHiddenPoints()
+{
+    auto hideInside = [this](int mainPolygon, int secPolygon) {
+        int mainBegin = store.getPolygonBegin(mainPolygon);
+        int mainSize = store.getPolygonEnd(mainPolygon) - mainBegin;
+
+        Polygon secPoints = store.getPolygon(secPolygon);
+        int insideCount = 0;
+        for (int point = mainBegin; point < mainBegin + mainSize; point++)
+        {
+            if (secPoints.containsPoint(store.getPoint(point)))
+            {
+                store.hide(point);
+                insideCount++;
+            }
+        }
+
+        // A convex hull whose vertices are all inside another convex hull lies entirely inside it
+        if (mainSize > 0 && insideCount == mainSize)
+        {
+            store.setAbsorbed(mainPolygon);
+        }
+    };
+
+    // Only polygons with overlapping bounding boxes can hide each other's vertices
+    for (const std::pair<int, int>& pair : index.findOverlappingPairs())
+    {
+        hideInside(pair.first, pair.second);
+        hideInside(pair.second, pair.first);
+    }
 }
 
+
+// Line of Sight //
+
 /*
- * Find line of sight between two points by checking for obstacles (polygons).
+ * Find line of sight between two vertices by checking for obstacles (polygons),
+ * and add the edge to the line of sight graph if nothing blocks it.
  *
- * @param currentStart - The starting point of the line of sight.
- * @param currentEnd - The ending point of the line of sight.
+ * @param currentStart - The vertex id the line of sight starts at.
+ * @param currentEnd - The vertex id the line of sight ends at.
  */
-void ControlManager::findlineOfSight(Point* currentStart, Point* currentEnd) 
+void ControlManager::findlineOfSight(int currentStart, int currentEnd) 
 {
-    if (currentStart == currentEnd) {
+    if (currentStart == currentEnd || !hasLineOfSight(currentStart, currentEnd)) {
         return;
     }
-    int counterCrossing = 0;
+
+    // Calculate and store the distance between currentStart and currentEnd
+    double distance = store.getPoint(currentStart).calculateDistance(store.getPoint(currentEnd));
+    graph.addEdge(currentStart, currentEnd, distance);
+}
+
+/*
+ * Check that no polygon edge crosses or touches the segment between two vertices,
+ * apart from the edges ending at the vertices themselves. The result does not depend
+ * on the order of the vertices.
+ *
+ * @param currentStart - The vertex id the line of sight starts at.
+ * @param currentEnd - The vertex id the line of sight ends at.
+ *
+ * @return True if the vertices are in line of sight of each other, false otherwise.
+ */
+bool ControlManager::hasLineOfSight(int currentStart, int currentEnd) const
+{
+    return hasLineOfSight(store.getPoint(currentStart), currentStart, store.getPoint(currentEnd), currentEnd);
+}
+
+/*
+ * Check that no polygon edge crosses or touches the segment between two points. The
+ * edges ending at a point that is a vertex of the graph are ignored.
+ *
+ * @param startPoint, endPoint - The endpoints of the segment.
+ * @param currentStart, currentEnd - The vertex ids of the endpoints, -1 for a point that is not a vertex.
+ *
+ * @return True if the points are in line of sight of each other, false otherwise.
+ */
+bool ControlManager::hasLineOfSight(const Point& startPoint, int currentStart, const Point& endPoint, int currentEnd) const
+{
+    const Scalar* xs = store.getXs();
+    const Scalar* ys = store.getYs();
 
     // Iterate over polygons and check for line crossings
     for (int checkPolygon = 0; checkPolygon < numPolygons; checkPolygon++) 
     {
-        auto& pointsArray = polygons[checkPolygon].getPolygonsPointsArray();
-        int size = pointsArray.size();
+        // A polygon merged into another obstacle is covered by its edges,
+        // and a polygon away from the segment cannot cross it
+        if (store.isAbsorbed(checkPolygon) || !index.mayTouch(checkPolygon, startPoint, endPoint))
+        {
+            continue;
+        }
+
+        int begin = store.getPolygonBegin(checkPolygon);
+        int end = store.getPolygonEnd(checkPolygon);
 
-        for (int crossPoint = 0; crossPoint < size; crossPoint++) 
+        for (int point1 = begin; point1 < end; point1++) 
         {
-            Point* point1 = &pointsArray[crossPoint];
-            Point* point2 = &pointsArray[(crossPoint + 1) % size];
+            int point2 = (point1 + 1 < end) ? point1 + 1 : begin;
 
             // Skip the current points
             if (point1 == currentEnd || point2 == currentStart || point2 == currentEnd || point1 == currentStart)
@@ -291,31 +648,251 @@ void ControlManager::findlineOfSight(Point* currentStart, Point* currentEnd)
             }
 
             // check if 2 lines are not crossing
-            if ((areLinesCrossing(*currentStart, *currentEnd, *point1, *point2)))
+            if ((areLinesCrossing(startPoint, endPoint, Point(xs[point1], ys[point1]), Point(xs[point2], ys[point2]))))
             {
-                counterCrossing++;
+                return false;
             }
         }
     }
 
-    // If no line crossings occurred, calculate and store the distance between currentStart and currentEnd
-    if (counterCrossing == 0)
+    return true;
+}
+
+/*
+ * Build the navigation mesh: a constrained Delaunay triangulation of the map
+ * with every convex hull edge as a constrained edge.
+ */
+void ControlManager::buildNavigationMesh()
+{
+    navMesh.build(store);
+}
+
+/*
+ * Rasterise the convex hulls into the occupancy grid used by the grid engine.
+ *
+ * @param resolution - The number of cells along the longer side of the map.
+ */
+void ControlManager::buildOccupancyGrid(int resolution)
+{
+    occupancyGrid.build(store, resolution);
+}
+
+/*
+ * Shorten the path greedily: from each kept point, jump to the farthest later point
+ * that can be reached by a straight segment clear of the exact convex hulls. The path
+ * points lie outside every hull, so a segment crossing no hull edge stays outside too.
+ */
+void ControlManager::smoothPath()
+{
+    if (path.size() < 3)
+    {
+        return;
+    }
+
+    std::vector<Point> smoothed;
+    smoothed.push_back(path.front());
+    size_t current = 0;
+    while (current + 1 < path.size())
     {
-        double distance = currentStart->calculateDistance(*currentEnd);
-        currentStart->setlineOfSight(currentEnd, distance);
+        size_t next = path.size() - 1;
+        while (next > current + 1 && !hasLineOfSight(path[current], -1, path[next], -1))
+        {
+            next--;
+        }
+        smoothed.push_back(path[next]);
+        current = next;
     }
+
+    path = smoothed;
 }
 
 /*
- * Find line of sight for all pairs of points.
+ * Find line of sight for all pairs of points and build the line of sight graph.
  */
 void ControlManager::findPointslineOfSight()
 {
+    findOverlappingPolygons();
+
+    // Small and medium maps keep one bit per pair of vertices
+    usingMatrix = matrixEnabled && store.getNumVertices() <= VisibilityMatrix::MAX_VERTICES;
+    if (usingMatrix)
+    {
+        graph.reset(0);
+        graph.build();
+        buildVisibilityMatrix();
+        return;
+    }
+
+    graph.reset(store.getNumVertices());
+
     allToAll();
     startPointToAll();
     allToEndPoint();
     endPointToAll();
     startPointToEndP();
+
+    graph.build();
+}
+
+/*
+ * Flag the polygons whose bounding box overlaps the bounding box of another polygon
+ * that is not merged into an obstacle. Only the hull edges of these polygons can
+ * pass through another obstacle.
+ */
+void ControlManager::findOverlappingPolygons()
+{
+    overlappingPolygons.assign(numPolygons, false);
+    for (const std::pair<int, int>& pair : index.findOverlappingPairs())
+    {
+        if (!store.isAbsorbed(pair.first) && !store.isAbsorbed(pair.second))
+        {
+            overlappingPolygons[pair.first] = true;
+            overlappingPolygons[pair.second] = true;
+        }
+    }
+}
+
+/*
+ * Check that a hull edge does not pass through another obstacle. Convex hulls that
+ * partly overlap keep the vertices outside each other, but the edge between two of
+ * them can still cross the other hull.
+ *
+ * @param polygon - The polygon of the edge.
+ * @param from, to - The vertex ids of the edge.
+ *
+ * @return True if the edge can be part of a route, false otherwise.
+ */
+bool ControlManager::isHullEdgeClear(int polygon, int from, int to) const
+{
+    return !overlappingPolygons[polygon] || hasLineOfSight(from, to);
+}
+
+/*
+ * Build the line of sight matrix. Line of sight is symmetric, so each unordered pair of
+ * vertices in different polygons is tested once, where the adjacency arrays test it
+ * once in each direction. The hull edges are recorded too, tested only where another
+ * obstacle may overlap them.
+ */
+void ControlManager::buildVisibilityMatrix()
+{
+    matrix.reset(store);
+
+    for (int mainPolygon = 0; mainPolygon < numPolygons; mainPolygon++)
+    {
+        int mainBegin = store.getPolygonBegin(mainPolygon);
+        int mainEnd = store.getPolygonEnd(mainPolygon);
+
+        for (int currentStart = mainBegin; currentStart < mainEnd; currentStart++)
+        {
+            // Hidden points are not part of the graph
+            if (store.isHidden(currentStart))
+            {
+                continue;
+            }
+
+            // Record the hull edge to the next point, the edge to the previous one is recorded from its other end
+            int next = (currentStart + 1 < mainEnd) ? currentStart + 1 : mainBegin;
+            if (next != currentStart && !store.isHidden(next) && isHullEdgeClear(mainPolygon, currentStart, next))
+            {
+                matrix.setVisible(currentStart, next);
+            }
+
+            // Pair the point with the points of the later polygons, then with the end point
+            for (int currentEnd = mainEnd; currentEnd < store.getNumVertices(); currentEnd++)
+            {
+                if (!store.isHidden(currentEnd) && hasLineOfSight(currentStart, currentEnd))
+                {
+                    matrix.setVisible(currentStart, currentEnd);
+                }
+            }
+
+            if (hasLineOfSight(GeometryStore::START_VERTEX, currentStart))
+            {
+                matrix.setVisible(GeometryStore::START_VERTEX, currentStart);
+            }
+
+            if (hasLineOfSight(currentStart, GeometryStore::END_VERTEX))
+            {
+                matrix.setVisible(currentStart, GeometryStore::END_VERTEX);
+            }
+        }
+    }
+
+    if (hasLineOfSight(GeometryStore::START_VERTEX, GeometryStore::END_VERTEX))
+    {
+        matrix.setVisible(GeometryStore::START_VERTEX, GeometryStore::END_VERTEX);
+    }
+}
+
+/*
+ * Compute the index of a point along a Hilbert curve filling a square grid.
+ *
+ * @param x, y - The cell of the point.
+ * @param n - The side of the grid, a power of two.
+ *
+ * @return The position of the cell along the curve.
+ */
+unsigned long long hilbertIndex(unsigned int x, unsigned int y, unsigned int n)
+{
+    unsigned long long index = 0;
+    for (unsigned int s = n / 2; s > 0; s /= 2)
+    {
+        unsigned int rx = (x & s) > 0;
+        unsigned int ry = (y & s) > 0;
+        index += (unsigned long long)s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant so the curve inside it has the standard orientation
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+/*
+ * Reorder the polygons in the store along a Hilbert curve over the map, by the centre of
+ * their bounding boxes. Polygons that are close on the map get nearby vertex ids, so the
+ * line of sight build and the neighbor scans of A* touch memory that is close together.
+ * The output files keep the input order of the polygons and neighbors.
+ * Must be called after pruneHiddenPoints() and before findPointslineOfSight().
+ */
+void ControlManager::reorderAlongHilbertCurve()
+{
+    const unsigned int gridSize = 1 << 16;
+    double scale = (mapSize > 0) ? (gridSize - 1) / (double)mapSize : 0.0;
+
+    std::vector<std::pair<unsigned long long, int>> keys;
+    keys.reserve(numPolygons);
+    for (int polygon = 0; polygon < numPolygons; polygon++)
+    {
+        const BoundingBox& box = index.getBox(polygon);
+        double x = std::min(std::max((box.minX + box.maxX) / 2 * scale, 0.0), gridSize - 1.0);
+        double y = std::min(std::max((box.minY + box.maxY) / 2 * scale, 0.0), gridSize - 1.0);
+        if (box.minX > box.maxX)
+        {
+            x = y = 0;
+        }
+        keys.push_back({ hilbertIndex((unsigned int)x, (unsigned int)y, gridSize), polygon });
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<int> order;
+    order.reserve(numPolygons);
+    for (const auto& key : keys)
+    {
+        order.push_back(key.second);
+    }
+
+    store.reorderPolygons(order);
+    index.build(store);
+    reordered = true;
 }
 
 /*
@@ -325,36 +902,45 @@ void ControlManager::allToAll()
 {
     for (int mainPolygon = 0; mainPolygon < numPolygons; mainPolygon++)
     {
-        auto& mainPoints = polygons[mainPolygon].getPolygonsPointsArray();
-        int mainSize = mainPoints.size();
+        int mainBegin = store.getPolygonBegin(mainPolygon);
+        int mainEnd = store.getPolygonEnd(mainPolygon);
 
-        for (int point = 0; point < mainSize; point++)
+        for (int currentStart = mainBegin; currentStart < mainEnd; currentStart++)
         {
-            Point* currentStart = &mainPoints[point];
+            // Hidden points are not part of the graph
+            if (store.isHidden(currentStart))
+            {
+                continue;
+            }
 
             for (int secPolygon = 0; secPolygon < numPolygons; secPolygon++)
             {
-                auto& secPoints = polygons[secPolygon].getPolygonsPointsArray();
-                int secSize = secPoints.size();
-
-                for (int point2 = 0; point2 < secSize; point2++)
+                if (mainPolygon != secPolygon)
                 {
-                    Point* currentEnd = &secPoints[point2];
-
-                    if (mainPolygon != secPolygon)
+                    for (int currentEnd = store.getPolygonBegin(secPolygon); currentEnd < store.getPolygonEnd(secPolygon); currentEnd++)
                     {
-                        // Use the setlineOfSight function to add/update neighbors
-                        findlineOfSight(currentStart, currentEnd);
+                        // Use the findlineOfSight function to add neighbors that are not hidden
+                        if (!store.isHidden(currentEnd))
+                        {
+                            findlineOfSight(currentStart, currentEnd);
+                        }
                     }
-                    else if (point != point2)
-                    {
-                        // add neighbors from right and left, if they are not the same point
-                        currentStart->setlineOfSight(&mainPoints[(point + 1) % mainSize],
-                            currentStart->calculateDistance(mainPoints[(point + 1) % mainSize]));
+                    continue;
+                }
 
-                        currentStart->setlineOfSight(&mainPoints[(point - 1 + mainSize) % mainSize],
-                            currentStart->calculateDistance(mainPoints[(point - 1 + mainSize) % mainSize]));
-                    }
+                // add neighbors from right and left once, if they are not the same point and not hidden
+                int next = (currentStart + 1 < mainEnd) ? currentStart + 1 : mainBegin;
+                int previous = (currentStart > mainBegin) ? currentStart - 1 : mainEnd - 1;
+
+                if (next != currentStart && !store.isHidden(next) && isHullEdgeClear(mainPolygon, currentStart, next))
+                {
+                    graph.addEdge(currentStart, next, store.getPoint(currentStart).calculateDistance(store.getPoint(next)));
+                }
+
+                if (previous != currentStart && previous != next && !store.isHidden(previous) &&
+                    isHullEdgeClear(mainPolygon, currentStart, previous))
+                {
+                    graph.addEdge(currentStart, previous, store.getPoint(currentStart).calculateDistance(store.getPoint(previous)));
                 }
             }
         }
@@ -367,15 +953,11 @@ void ControlManager::allToAll()
  */
 void ControlManager::startPointToAll()
 {
-    Point* currentStart = &startPoint;
-
-    for (size_t mainPolygon = 0; mainPolygon < numPolygons; mainPolygon++)
+    for (int currentEnd = store.getPolygonBegin(0); currentEnd < store.getNumVertices(); currentEnd++)
     {
-        for (size_t point = 0; point < (this->polygons[mainPolygon].getPolygonsPointsArray()).size(); point++)
+        if (!store.isHidden(currentEnd))
         {
-            Point* currentEnd = &(polygons[mainPolygon].getPolygonsPointsArray()[point]);
-
-            findlineOfSight(currentStart, currentEnd);
+            findlineOfSight(GeometryStore::START_VERTEX, currentEnd);
         }
     }
 }
@@ -385,19 +967,11 @@ void ControlManager::startPointToAll()
  */
 void ControlManager::allToEndPoint()
 {
-    for (int mainPolygon = 0; mainPolygon < numPolygons; mainPolygon++)
+    for (int currentStart = store.getPolygonBegin(0); currentStart < store.getNumVertices(); currentStart++)
     {
-        auto& mainPoints = polygons[mainPolygon].getPolygonsPointsArray();
-        int mainSize = mainPoints.size();
-
-        for (int point = 0; point < mainSize; point++)
+        if (!store.isHidden(currentStart))
         {
-            Point* currentStart = &mainPoints[point];
-            Point* currentEnd = &endPoint;
-
-            findlineOfSight(currentStart, currentEnd);
-                
-            
+            findlineOfSight(currentStart, GeometryStore::END_VERTEX);
         }
     }
 }
@@ -407,17 +981,11 @@ void ControlManager::allToEndPoint()
  */
 void ControlManager::endPointToAll()
 {
-    Point* currentStart = &endPoint;
-
-    for (size_t mainPolygon = 0; mainPolygon < numPolygons; mainPolygon++)
+    for (int currentEnd = store.getPolygonBegin(0); currentEnd < store.getNumVertices(); currentEnd++)
     {
-        for (size_t point = 0; point < (this->polygons[mainPolygon].getPolygonsPointsArray()).size(); point++)
+        if (!store.isHidden(currentEnd))
         {
-            Point* currentEnd = &(polygons[mainPolygon].getPolygonsPointsArray()[point]);
-
-            findlineOfSight(currentStart, currentEnd);
-
-
+            findlineOfSight(GeometryStore::END_VERTEX, currentEnd);
         }
     }
 }
@@ -427,11 +995,7 @@ void ControlManager::endPointToAll()
  */
 void ControlManager::startPointToEndP()
 {
-    Point* currentStart = &startPoint;
-
-    Point* currentEnd = &endPoint;
-
-    findlineOfSight(currentStart, currentEnd);
+    findlineOfSight(GeometryStore::START_VERTEX, GeometryStore::END_VERTEX);
 }
 
 /*
@@ -445,25 +1009,23 @@ void ControlManager::writelineOfSight()
     std::ofstream outFile("neighborsFile.txt");
 
     // Write line of sight information for the start point
-    const std::vector<std::pair<Point*, double>>& startlineOfSight = this->startPoint.getlineOfSight();
-    outlineOfSightArrayWithDistances(startlineOfSight, outFile);
+    outlineOfSightArrayWithDistances(GeometryStore::START_VERTEX, outFile);
 
     // Write line of sight information for the end point
-    const std::vector<std::pair<Point*, double>>& endlineOfSight = this->endPoint.getlineOfSight();
-    outlineOfSightArrayWithDistances(endlineOfSight, outFile);
+    outlineOfSightArrayWithDistances(GeometryStore::END_VERTEX, outFile);
 
-    // Write line of sight information for each polygon's points
+    // Write line of sight information for each polygon's points, in input order
     for (int polygonNumber = 0; polygonNumber < numPolygons; polygonNumber++)
     {
-        const auto& polygonPoints = polygons[polygonNumber].getPolygonsPointsArray();
-        int pointsNumber = polygonPoints.size();
+        int polygon = store.getRankedPolygon(polygonNumber);
+        int begin = store.getPolygonBegin(polygon);
+        int pointsNumber = store.getPolygonEnd(polygon) - begin;
         outFile << polygonNumber << "\n" << pointsNumber << "\n";
 
         // Write line of sight information for each point in the polygon
         for (int j = 0; j < pointsNumber; j++)
         {
-            const std::vector<std::pair<Point*, double>>& pointlineOfSight = polygonPoints[j].getlineOfSight();
-            outlineOfSightArrayWithDistances(pointlineOfSight, outFile);
+            outlineOfSightArrayWithDistances(begin + j, outFile);
         }
 
         outFile << "\n";
@@ -473,138 +1035,381 @@ void ControlManager::writelineOfSight()
 }
 
 /*
- * Write neighbors array with distances to the file.
+ * Write the neighbors of a vertex with their distances to the file.
  *
- * @param lineOfSightArray - The array containing neighbors and their distances.
+ * @param vertex - The vertex id whose neighbors are written.
  * @param outFile - The output file stream to write the information.
  */
-void ControlManager::outlineOfSightArrayWithDistances(const std::vector<std::pair<Point*, double>>& lineOfSightArray, std::ofstream& outFile)
+void ControlManager::outlineOfSightArrayWithDistances(int vertex, std::ofstream& outFile)
 {
-    outFile << lineOfSightArray.size() << "\n";
-    // Iterate over the lineOfSightArray and write each Point and distance to the file
-    for (const auto& neighbor : lineOfSightArray)
+    std::vector<std::pair<int, Scalar>> neighbors;
+    auto collect = [&](int neighbor, Scalar distance) {
+        neighbors.push_back({ neighbor, distance });
+    };
+    if (usingMatrix) {
+        matrix.forEachNeighbor(vertex, collect);
+    }
+    else {
+        graph.forEachNeighbor(vertex, collect);
+    }
+
+    // The graph keeps the neighbors in store order for the search; write them in the order of
+    // the input polygons, which is the order they are added in when the polygons are not
+    // reordered: by polygon, with the hull neighbors of a vertex (next, then previous) in the
+    // place of its own polygon, and the end point last.
+    if (reordered)
+    {
+        int ownPolygon = store.getVertexPolygon(vertex);
+        auto position = [&](int neighbor) {
+            if (neighbor == GeometryStore::END_VERTEX)
+            {
+                return std::make_pair(numPolygons, 0);
+            }
+
+            int polygon = store.getVertexPolygon(neighbor);
+            int begin = store.getPolygonBegin(polygon);
+            int offset = neighbor - begin;
+            if (polygon == ownPolygon)
+            {
+                int next = (vertex + 1 < store.getPolygonEnd(polygon)) ? vertex + 1 : begin;
+                offset = (neighbor == next) ? 0 : 1;
+            }
+            return std::make_pair(store.getPolygonRank(polygon), offset);
+        };
+
+        std::sort(neighbors.begin(), neighbors.end(), [&](const std::pair<int, Scalar>& a, const std::pair<int, Scalar>& b) {
+            return position(a.first) < position(b.first);
+        });
+    }
+
+    outFile << neighbors.size() << "\n";
+    // Iterate over the neighbors and write each point and distance to the file
+    for (const auto& neighbor : neighbors)
     {
-        outFile << neighbor.first->getX() << ", " << neighbor.first->getY() << ", " << neighbor.second << "\n";
+        outFile << store.getX(neighbor.first) << ", " << store.getY(neighbor.first) << ", " << neighbor.second << "\n";
     }
 }
 
 /*
- * Reconstruct the path from the A* algorithm result.
+ * Find the shortest route between start and goal vertices with the A* algorithm
+ * on the line of sight graph.
  *
- * @param cameFrom - A map containing the relationships between points in the path.
- * @param current - The current point being processed.
+ * @param start - The starting vertex id.
+ * @param goal - The goal vertex id.
  *
- * @return A vector of points representing the reconstructed path.
+ * @return A vector of vertex ids representing the shortest path.
  */
-std::vector<Point> reconstructPath(const std::unordered_map<Point*, Point*>& cameFrom, Point* current) {
-    std::vector<Point> totalPath;
-    totalPath.push_back(*current);
+std::vector<int> ControlManager::aStar(int start, int goal)
+{
+    Point goalPoint = store.getPoint(goal);
 
-    while (cameFrom.find(current) != cameFrom.end()) {
-        current = cameFrom.at(current);
-        totalPath.insert(totalPath.begin(), *current);
-    }
+    auto heuristic = [&](int vertex) {
+        return store.getPoint(vertex).calculateDistance(goalPoint);
+    };
 
-    return totalPath;
+    if (usingMatrix) {
+        return ::aStar(matrix, start, goal, heuristic);
+    }
+    return ::aStar(graph, start, goal, heuristic);
 }
 
 /*
- * Implementation of the A* algorithm to find the shortest route between start and goal points.
+ * Find a route between start and goal vertices with anytime A* on the line of sight
+ * graph. A first route at most 3 times longer than the shortest one is found quickly,
+ * then it is improved in rounds with a decreasing weight until the deadline passes or
+ * the route is the shortest one.
  *
- * @param start - The starting point.
- * @param goal - The goal point.
+ * @param start - The starting vertex id.
+ * @param goal - The goal vertex id.
+ * @param deadline - The time at which the search stops improving the route.
+ * @param bound - Set to the factor by which the route may be longer than the shortest one.
  *
- * @return A vector of points representing the shortest path.
+ * @return A vector of vertex ids representing the best route found.
  */
-std::vector<Point> ControlManager::aStar(Point& start, Point& goal)
+std::vector<int> ControlManager::aStar(int start, int goal, std::chrono::steady_clock::time_point deadline, double& bound)
 {
-    std::priority_queue<std::pair<double, Point*>, std::vector<std::pair<double, Point*>>, std::greater<>> openSet;
-    std::unordered_map<Point*, double> gScore;
-    std::unordered_map<Point*, double> fScore;
-    std::unordered_map<Point*, Point*> cameFrom;
-    std::unordered_set<Point*> processedPoints;
+    Point goalPoint = store.getPoint(goal);
+    auto heuristic = [&](int vertex) {
+        return store.getPoint(vertex).calculateDistance(goalPoint);
+    };
+
+    if (usingMatrix) {
+        AnytimeAStar<VisibilityMatrix, decltype(heuristic)> search(matrix, start, goal, heuristic, 3.0, 0.5);
+        search.search(deadline);
 
-    // Initialize gScore with infinity for all nodes
-    for (const auto& neighborInfo : start.getlineOfSight()) {
-        Point* neighbor = neighborInfo.first;
-        gScore[neighbor] = std::numeric_limits<double>::infinity();
+        bound = search.getBound();
+        return search.getPath();
     }
 
-    gScore[&start] = 0;
+    AnytimeAStar<VisibilityGraph, decltype(heuristic)> search(graph, start, goal, heuristic, 3.0, 0.5);
+    search.search(deadline);
+
+    bound = search.getBound();
+    return search.getPath();
+}
+
 
-    // Initialize fScore with infinity for all nodes
-    for (const auto& neighborInfo : start.getlineOfSight()) {
-        Point* neighbor = neighborInfo.first;
-        fScore[neighbor] = std::numeric_limits<double>::infinity();
+/*
+ * Find the shortest route using the A* algorithm and save it to a text file.
+ */
+void ControlManager::findShortestRoute()
+{
+    path.clear();
+    if (engine == Engine::NavigationMesh) {
+        path = navMesh.findPath(store.getPoint(GeometryStore::START_VERTEX), store.getPoint(GeometryStore::END_VERTEX));
+    }
+    else if (engine == Engine::Grid) {
+        path = occupancyGrid.findPath(store.getPoint(GeometryStore::START_VERTEX), store.getPoint(GeometryStore::END_VERTEX));
+        if (smoothing) {
+            smoothPath();
+        }
+    }
+    else if (hasDeadline) {
+        for (int vertex : aStar(GeometryStore::START_VERTEX, GeometryStore::END_VERTEX, deadline, pathBound)) {
+            path.push_back(store.getPoint(vertex));
+        }
+        std::cout << "Suboptimality bound: " << pathBound << std::endl;
+    }
+    else {
+        for (int vertex : aStar(GeometryStore::START_VERTEX, GeometryStore::END_VERTEX)) {
+            path.push_back(store.getPoint(vertex));
+        }
+    }
+
+    if (path.empty()) 
+    {
+        // Handle failure
+        std::cout << "Path not found." << std::endl;
+    }
+    else if (writePathFile) {
+        writePath();
+    }
+}
+
+/*
+ * Save the path to shortest_path.txt.
+ */
+void ControlManager::writePath()
+{
+    std::ofstream outFile("shortest_path.txt");
+
+    if (outFile.is_open()) {
+        for (const auto& point : path) {
+            outFile << point.getX() << " " << point.getY() << " ";
+        }
+        outFile.close();
+        std::cout << "Path saved to shortest_path.txt." << std::endl;
+    }
+    else {
+        std::cerr << "Unable to open file for writing." << std::endl;
+    }
+}
+
+/*
+ * Find the k shortest loopless routes on the line of sight graph with Yen's algorithm.
+ * The shortest one becomes the path.
+ *
+ * @param k - The number of routes to find.
+ *
+ * @return Up to k routes as vertex id sequences with their lengths, shortest first.
+ */
+std::vector<Route> ControlManager::findAlternativeRoutes(int k)
+{
+    Point goalPoint = store.getPoint(GeometryStore::END_VERTEX);
+    auto heuristic = [&](int vertex) {
+        return store.getPoint(vertex).calculateDistance(goalPoint);
+    };
+
+    std::vector<Route> routes = usingMatrix ?
+        kShortestPaths(matrix, GeometryStore::START_VERTEX, GeometryStore::END_VERTEX, k, heuristic) :
+        kShortestPaths(graph, GeometryStore::START_VERTEX, GeometryStore::END_VERTEX, k, heuristic);
+
+    path.clear();
+    if (routes.empty()) {
+        std::cout << "Path not found." << std::endl;
+        return routes;
     }
 
-    fScore[&start] = start.calculateDistance(goal);
+    for (size_t i = 0; i < routes.size(); i++) {
+        std::cout << "Route " << i + 1 << ": length " << routes[i].length << ", " << routes[i].vertices.size() << " points" << std::endl;
+    }
 
-    openSet.push({ 0, &start });
+    for (int vertex : routes[0].vertices) {
+        path.push_back(store.getPoint(vertex));
+    }
+    if (writePathFile) {
+        writePath();
+    }
 
-    while (!openSet.empty()) {
-        Point* current = openSet.top().second;
-        openSet.pop();
+    return routes;
+}
+
+/*
+ * Print the memory used by the geometry store and the line of sight graph, and the
+ * size of the scalar type the program was built with.
+ */
+void ControlManager::reportMemoryUsage() const
+{
+    std::cout << "Scalar size: " << sizeof(Scalar) << " bytes" << std::endl;
+    std::cout << "Geometry memory: " << store.getMemoryUsage() << " bytes" << std::endl;
+    std::cout << "Graph memory: " << (usingMatrix ? matrix.getMemoryUsage() : graph.getMemoryUsage()) << " bytes" << std::endl;
+}
 
-        // Skip if the point is already processed
-        if (processedPoints.find(current) != processedPoints.end()) {
+/*
+ * Check if a point lies strictly inside one of the convex hulls.
+ *
+ * @param point - The point to check.
+ *
+ * @return True if the point is inside an obstacle, false otherwise.
+ */
+bool ControlManager::isInsideObstacle(const Point& point) const
+{
+    for (int polygon = 0; polygon < numPolygons; polygon++)
+    {
+        // A merged polygon lies inside the hull it was merged into
+        if (store.isAbsorbed(polygon) || !index.mayTouch(polygon, point, point))
+        {
             continue;
         }
 
-        processedPoints.insert(current);
-
-        if (*current == goal) {
-            return reconstructPath(cameFrom, current);
+        if (store.getPolygon(polygon).containsPoint(point))
+        {
+            return true;
         }
+    }
 
-        for (const auto& neighborInfo : current->getlineOfSight()) {
-            Point* neighbor = neighborInfo.first;
-            if (gScore.find(neighbor) == gScore.end()) {
-                gScore[neighbor] = INFINITY;
-            }
-            double distanceToNeighbor = neighborInfo.second;
-            double tentativeGScore = gScore[current] + distanceToNeighbor;
+    return false;
+}
+
+/*
+ * The line of sight graph with the start and end points of the map replaced by the
+ * points of a query. The edges of the query points are computed for the query, the
+ * shared graph is only read.
+ */
+template <typename Graph>
+struct QueryGraph
+{
+    const Graph& graph;
+
+    // Vertices in line of sight of the query start, with their distances
+    std::vector<std::pair<int, Scalar>> startNeighbors;
+
+    // Distance of each vertex to the query goal, negative if the goal is out of sight
+    std::vector<Scalar> goalDistances;
 
-            if (tentativeGScore < gScore[neighbor]) {
-                cameFrom[neighbor] = current;
-                gScore[neighbor] = tentativeGScore;
-                fScore[neighbor] = tentativeGScore + neighbor->calculateDistance(goal);
+    int getNumVertices() const
+    {
+        return graph.getNumVertices();
+    }
 
-                openSet.push({ fScore[neighbor], neighbor });
+    template <typename Visitor>
+    void forEachNeighbor(int vertex, Visitor visit) const
+    {
+        if (vertex == GeometryStore::START_VERTEX)
+        {
+            for (const auto& neighbor : startNeighbors)
+            {
+                visit(neighbor.first, neighbor.second);
             }
+            return;
         }
-    }
 
-    std::vector<Point> result;
-    return result;
-}
+        graph.forEachNeighbor(vertex, [&](int neighbor, Scalar distance) {
+            if (neighbor != GeometryStore::START_VERTEX && neighbor != GeometryStore::END_VERTEX)
+            {
+                visit(neighbor, distance);
+            }
+        });
 
+        if (goalDistances[vertex] >= 0)
+        {
+            visit((int)GeometryStore::END_VERTEX, goalDistances[vertex]);
+        }
+    }
+};
 
 /*
- * Find the shortest route using the A* algorithm and save it to a text file.
+ * Find the shortest route with A* on a query graph.
+ *
+ * @param graph - The line of sight graph of the map.
+ * @param lineOfSight - Checks the line of sight from a query point to a point with a vertex id, -1 if none.
+ * @param store - The store holding the vertices.
+ * @param from, to - The endpoints of the route.
+ *
+ * @return The vertex ids of the route, with the start and end vertices standing for the query points.
  */
-void ControlManager::findShortestRoute()
+template <typename Graph, typename LineOfSight>
+std::vector<int> findQueryRoute(const Graph& graph, LineOfSight lineOfSight, const GeometryStore& store, const Point& from, const Point& to)
 {
-    this->setPath(aStar(startPoint, endPoint));
+    QueryGraph<Graph> queryGraph = { graph, {}, std::vector<Scalar>(store.getNumVertices(), -1) };
 
-    if (path.empty()) 
+    for (int vertex = GeometryStore::END_VERTEX + 1; vertex < store.getNumVertices(); vertex++)
     {
-        // Handle failure
-        std::cout << "Path not found." << std::endl;
+        if (store.isHidden(vertex))
+        {
+            continue;
+        }
+
+        Point point = store.getPoint(vertex);
+        if (lineOfSight(from, point, vertex))
+        {
+            queryGraph.startNeighbors.push_back({ vertex, from.calculateDistance(point) });
+        }
+        if (lineOfSight(to, point, vertex))
+        {
+            queryGraph.goalDistances[vertex] = point.calculateDistance(to);
+        }
     }
-    else {
-        // Save the found path to a text file
-        std::ofstream outFile("shortest_path.txt");
 
-        if (outFile.is_open()) {
-            for (const auto& point : path) {
-                outFile << point.getX() << " " << point.getY() << " ";
-            }
-            outFile.close();
-            std::cout << "Path saved to shortest_path.txt." << std::endl;
+    if (lineOfSight(from, to, -1))
+    {
+        queryGraph.startNeighbors.push_back({ (int)GeometryStore::END_VERTEX, from.calculateDistance(to) });
+    }
+
+    return aStar(queryGraph, GeometryStore::START_VERTEX, GeometryStore::END_VERTEX, [&](int vertex) {
+        Point point = (vertex == GeometryStore::START_VERTEX) ? from : store.getPoint(vertex);
+        return (vertex == GeometryStore::END_VERTEX) ? Scalar(0) : point.calculateDistance(to);
+    });
+}
+
+/*
+ * Find the shortest route between two points on the line of sight graph built by
+ * findPointslineOfSight(). The points need not be the start and end points of the map:
+ * their lines of sight are computed for the query. The manager is only read, so
+ * several threads may query it at once.
+ *
+ * @param from - The point the route starts at.
+ * @param to - The point the route ends at.
+ * @param route - Set to the points of the route.
+ *
+ * @return True if a route was found, false otherwise.
+ */
+bool ControlManager::findRoute(const Point& from, const Point& to, std::vector<Point>& route) const
+{
+    auto lineOfSight = [&](const Point& queryPoint, const Point& point, int vertex) {
+        return hasLineOfSight(queryPoint, -1, point, vertex);
+    };
+
+    std::vector<int> vertices = usingMatrix ?
+        findQueryRoute(matrix, lineOfSight, store, from, to) :
+        findQueryRoute(graph, lineOfSight, store, from, to);
+
+    route.clear();
+    for (int vertex : vertices)
+    {
+        if (vertex == GeometryStore::START_VERTEX)
+        {
+            route.push_back(from);
         }
-        else {
-            std::cerr << "Unable to open file for writing." << std::endl;
+        else if (vertex == GeometryStore::END_VERTEX)
+        {
+            route.push_back(to);
+        }
+        else
+        {
+            route.push_back(store.getPoint(vertex));
         }
     }
+
+    return !route.empty();
 }
\ No newline at end of file
@@ -1,18 +1,55 @@
 #pragma once
+#include <chrono>
 #include <string>
 #include <fstream>
 #include <unordered_map>
 #include <vector>
 #include "Map.h"
 #include "Point.h"
+#include "GeometryStore.h"
+#include "VisibilityGraph.h"
+#include "VisibilityMatrix.h"
+#include "NavMesh.h"
+#include "OccupancyGrid.h"
+#include "PolygonIndex.h"
+#include "KShortestPaths.h"
 
+// Engines available for finding the shortest route
+enum class Engine {
+    VisibilityGraph,
+    NavigationMesh,
+    Grid
+};
 
 class ControlManager {
 private:
     int mapSize, numPolygons;
-    std::vector<Polygon> polygons;
-    Point startPoint;
-    Point endPoint;
+    GeometryStore store;
+    PolygonIndex index;
+    VisibilityGraph graph;
+    VisibilityMatrix matrix;
+    NavMesh navMesh;
+    OccupancyGrid occupancyGrid;
+    Engine engine;
+    bool smoothing;
+
+    // True once the polygons are stored in a different order than the input
+    bool reordered;
+
+    // True to use the line of sight matrix on maps small enough for it, and true if the graph is in it
+    bool matrixEnabled;
+    bool usingMatrix;
+
+    // Polygons whose bounding box overlaps another one, their hull edges need a line of sight test
+    std::vector<char> overlappingPolygons;
+
+    // Time by which the route must be found, if any, and the suboptimality bound of the path
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+    double pathBound;
+
+    // True to save the path to shortest_path.txt
+    bool writePathFile;
     std::vector<Point> path;
 
     // Functions for initializing line of sight information
@@ -22,14 +59,38 @@ private:
     void endPointToAll();
     void startPointToEndP();
 
-    // Function to find line of sight between two points
-    void findlineOfSight(Point* currentStart, Point* currentEnd);
+    // Function to find line of sight between two vertices
+    void findlineOfSight(int currentStart, int currentEnd);
+
+    // Check that no polygon blocks the line of sight between two vertices
+    bool hasLineOfSight(int currentStart, int currentEnd) const;
+
+    // Check the line of sight between two points, each a vertex id or -1 for a point off the graph
+    bool hasLineOfSight(const Point& startPoint, int currentStart, const Point& endPoint, int currentEnd) const;
 
-    // Function to write line of sight information to a file
-    void outlineOfSightArrayWithDistances(const std::vector<std::pair<Point*, double>>& lineOfSightArray, std::ofstream& outFile);
+    // Test each pair of vertices once and record the result in the matrix
+    void buildVisibilityMatrix();
 
-    // A* algorithm implementation for finding the shortest route
-    std::vector<Point> aStar(Point& start, Point& goal);
+    // Flag the polygons whose hull edges need a line of sight test
+    void findOverlappingPolygons();
+
+    // Check that a hull edge does not pass through another obstacle
+    bool isHullEdgeClear(int polygon, int from, int to) const;
+
+    // Function to write line of sight information of a vertex to a file
+    void outlineOfSightArrayWithDistances(int vertex, std::ofstream& outFile);
+
+    // Shorten the path with straight segments checked against the exact convex hulls
+    void smoothPath();
+
+    // Save the path to shortest_path.txt
+    void writePath();
+
+    // A* algorithm implementation for finding the shortest route between two vertices
+    std::vector<int> aStar(int start, int goal);
+
+    // Anytime A* that improves the route until the deadline, setting the suboptimality bound of the result
+    std::vector<int> aStar(int start, int goal, std::chrono::steady_clock::time_point deadline, double& bound);
 public:
     // Constructor
     ControlManager();
@@ -40,8 +101,14 @@ public:
     // Setter for the path
     void setPath(const std::vector<Point>& newPath);
 
-    // Read map data from a file
-    void readData(const std::string& filename);
+    // Select the engine used to find the shortest route
+    void setEngine(Engine newEngine);
+
+    // Read map data from a file, false if it cannot be opened or is malformed
+    bool readData(const std::string& filename);
+
+    // Read map data from a file and compute the convex hulls in a pipeline, false if it cannot be opened or is malformed
+    bool readDataPipelined(const std::string& filename, int numWorkers);
 
     // Write map data to a file
     void writeData();
@@ -49,12 +116,51 @@ public:
     // Convex hull computation
     void performConvexHull();
 
+    // Remove vertices hidden inside other obstacles from the graph candidates
+    void pruneHiddenPoints();
+
+    // Reorder the polygons along a Hilbert curve for memory locality
+    void reorderAlongHilbertCurve();
+
     // Find line of sight for all points
     void findPointslineOfSight();
 
     // Write line of sight information to a file
     void writelineOfSight();
 
-    // Find the shortest route using A* algorithm
+    // Enable the bit-packed line of sight matrix for small and medium maps
+    void setVisibilityMatrix(bool enabled);
+
+    // Build the navigation mesh around the convex hulls
+    void buildNavigationMesh();
+
+    // Rasterise the convex hulls into the occupancy grid
+    void buildOccupancyGrid(int resolution);
+
+    // Enable shortening the path found on the grid against the exact convex hulls
+    void setSmoothing(bool enabled);
+
+    // Set the time by which the route must be found, trading route length for time
+    void setDeadline(std::chrono::steady_clock::time_point newDeadline);
+
+    // Get the suboptimality bound of the path: it is at most this many times longer than the shortest route
+    double getPathBound() const;
+
+    // Enable saving the path to shortest_path.txt
+    void setPathFileOutput(bool enabled);
+
+    // Find the k shortest loopless routes on the line of sight graph
+    std::vector<Route> findAlternativeRoutes(int k);
+
+    // Find the shortest route with the selected engine
     void findShortestRoute();
+
+    // Print the memory used by the geometry and the line of sight graph
+    void reportMemoryUsage() const;
+
+    // Check if a point lies strictly inside an obstacle
+    bool isInsideObstacle(const Point& point) const;
+
+    // Find the shortest route between any two points on the built line of sight graph, safe to call from several threads
+    bool findRoute(const Point& from, const Point& to, std::vector<Point>& route) const;
 };
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include "GeometryStore.h"
+#include <algorithm>
+
+// Constructor implementation
+template <typename T>
+BasicGeometryStore<T>::BasicGeometryStore()
+{
+    reset(BasicPoint<T>(0, 0), BasicPoint<T>(0, 0));
+}
+
+/*
+ * Remove all geometry and set the start and end points.
+ *
+ * @param start - The start point of the route.
+ * @param end - The end point of the route.
+ */
+template <typename T>
+void BasicGeometryStore<T>::reset(const BasicPoint<T>& start, const BasicPoint<T>& end)
+{
+    xs.assign({ start.getX(), end.getX() });
+    ys.assign({ start.getY(), end.getY() });
+    hidden.assign(2, false);
+    polygonOffsets.assign(1, 2);
+    polygonNumbers.clear();
+    absorbed.clear();
+    polygonRanks.clear();
+    rankedPolygons.clear();
+}
+
+/*
+ * Reserve space for polygons and their vertices, so reading a map does not reallocate.
+ *
+ * @param numPolygons - The expected number of polygons.
+ * @param numPoints - The expected number of polygon vertices.
+ */
+template <typename T>
+void BasicGeometryStore<T>::reserve(int numPolygons, int numPoints)
+{
+    xs.reserve(numPoints + 2);
+    ys.reserve(numPoints + 2);
+    hidden.reserve(numPoints + 2);
+    polygonOffsets.reserve(numPolygons + 1);
+    polygonNumbers.reserve(numPolygons);
+    absorbed.reserve(numPolygons);
+    polygonRanks.reserve(numPolygons);
+    rankedPolygons.reserve(numPolygons);
+}
+
+/*
+ * Start a new polygon. Vertices added afterwards belong to it.
+ *
+ * @param number - The identifier of the polygon as read from the input.
+ */
+template <typename T>
+void BasicGeometryStore<T>::beginPolygon(int number)
+{
+    polygonRanks.push_back(polygonNumbers.size());
+    rankedPolygons.push_back(polygonNumbers.size());
+    polygonNumbers.push_back(number);
+    absorbed.push_back(false);
+    polygonOffsets.push_back(polygonOffsets.back());
+}
+
+/*
+ * Add a vertex to the last polygon.
+ *
+ * @param x, y - The coordinates of the vertex.
+ */
+template <typename T>
+void BasicGeometryStore<T>::addPoint(T x, T y)
+{
+    xs.push_back(x);
+    ys.push_back(y);
+    hidden.push_back(false);
+    polygonOffsets.back()++;
+}
+
+/*
+ * Keep only the first vertices of each polygon and move the polygons so they are
+ * contiguous again. Used after the vertices of each polygon were rewritten in place.
+ *
+ * @param sizes - The number of vertices to keep for each polygon.
+ */
+template <typename T>
+void BasicGeometryStore<T>::truncatePolygons(const std::vector<int>& sizes)
+{
+    int write = polygonOffsets[0];
+
+    for (int polygon = 0; polygon < getNumPolygons(); polygon++)
+    {
+        int begin = polygonOffsets[polygon];
+
+        // The destination never overtakes the source, so moving forward is safe
+        std::copy(xs.begin() + begin, xs.begin() + begin + sizes[polygon], xs.begin() + write);
+        std::copy(ys.begin() + begin, ys.begin() + begin + sizes[polygon], ys.begin() + write);
+        std::copy(hidden.begin() + begin, hidden.begin() + begin + sizes[polygon], hidden.begin() + write);
+
+        polygonOffsets[polygon] = write;
+        write += sizes[polygon];
+    }
+
+    polygonOffsets.back() = write;
+    xs.resize(write);
+    ys.resize(write);
+    hidden.resize(write);
+}
+
+/*
+ * Move the polygons into a new order. The vertices of each polygon stay contiguous and
+ * in the same order, only the polygons move, so vertex ids change but every polygon
+ * keeps its shape, flags and input position.
+ *
+ * @param order - The current index of the polygon to place at each new index.
+ */
+template <typename T>
+void BasicGeometryStore<T>::reorderPolygons(const std::vector<int>& order)
+{
+    int numVertices = getNumVertices();
+    std::vector<T> newXs(xs.begin(), xs.begin() + polygonOffsets[0]);
+    std::vector<T> newYs(ys.begin(), ys.begin() + polygonOffsets[0]);
+    std::vector<char> newHidden(hidden.begin(), hidden.begin() + polygonOffsets[0]);
+    std::vector<int> newOffsets(1, polygonOffsets[0]);
+    std::vector<int> newNumbers, newRanks;
+    std::vector<char> newAbsorbed;
+    newXs.reserve(numVertices);
+    newYs.reserve(numVertices);
+    newHidden.reserve(numVertices);
+
+    for (int polygon : order)
+    {
+        int begin = polygonOffsets[polygon];
+        int end = polygonOffsets[polygon + 1];
+        newXs.insert(newXs.end(), xs.begin() + begin, xs.begin() + end);
+        newYs.insert(newYs.end(), ys.begin() + begin, ys.begin() + end);
+        newHidden.insert(newHidden.end(), hidden.begin() + begin, hidden.begin() + end);
+        newOffsets.push_back(newXs.size());
+        newNumbers.push_back(polygonNumbers[polygon]);
+        newRanks.push_back(polygonRanks[polygon]);
+        newAbsorbed.push_back(absorbed[polygon]);
+    }
+
+    xs.swap(newXs);
+    ys.swap(newYs);
+    hidden.swap(newHidden);
+    polygonOffsets.swap(newOffsets);
+    polygonNumbers.swap(newNumbers);
+    polygonRanks.swap(newRanks);
+    absorbed.swap(newAbsorbed);
+
+    for (int polygon = 0; polygon < getNumPolygons(); polygon++)
+    {
+        rankedPolygons[polygonRanks[polygon]] = polygon;
+    }
+}
+
+// Getter implementation for the number of vertices
+template <typename T>
+int BasicGeometryStore<T>::getNumVertices() const
+{
+    return xs.size();
+}
+
+// Getter implementation for the number of polygons
+template <typename T>
+int BasicGeometryStore<T>::getNumPolygons() const
+{
+    return polygonNumbers.size();
+}
+
+// Getter implementation for the first vertex of a polygon
+template <typename T>
+int BasicGeometryStore<T>::getPolygonBegin(int polygon) const
+{
+    return polygonOffsets[polygon];
+}
+
+// Getter implementation for the end of the vertices of a polygon
+template <typename T>
+int BasicGeometryStore<T>::getPolygonEnd(int polygon) const
+{
+    return polygonOffsets[polygon + 1];
+}
+
+// Getter implementation for a polygon view
+template <typename T>
+BasicPolygon<T> BasicGeometryStore<T>::getPolygon(int polygon) const
+{
+    return BasicPolygon<T>(*this, polygon);
+}
+
+// Getter implementation for the identifier of a polygon
+template <typename T>
+int BasicGeometryStore<T>::getPolygonNumber(int polygon) const
+{
+    return polygonNumbers[polygon];
+}
+
+// Getter implementation for the input position of a polygon
+template <typename T>
+int BasicGeometryStore<T>::getPolygonRank(int polygon) const
+{
+    return polygonRanks[polygon];
+}
+
+// Getter implementation for the polygon at an input position
+template <typename T>
+int BasicGeometryStore<T>::getRankedPolygon(int rank) const
+{
+    return rankedPolygons[rank];
+}
+
+/*
+ * Find the polygon a vertex belongs to in the offset table.
+ *
+ * @param vertex - The vertex id.
+ *
+ * @return The polygon holding the vertex, -1 for the start and end points.
+ */
+template <typename T>
+int BasicGeometryStore<T>::getVertexPolygon(int vertex) const
+{
+    return (int)(std::upper_bound(polygonOffsets.begin(), polygonOffsets.end() - 1, vertex) - polygonOffsets.begin()) - 1;
+}
+
+// Getter implementation for x-coordinate
+template <typename T>
+T BasicGeometryStore<T>::getX(int vertex) const
+{
+    return xs[vertex];
+}
+
+// Getter implementation for y-coordinate
+template <typename T>
+T BasicGeometryStore<T>::getY(int vertex) const
+{
+    return ys[vertex];
+}
+
+// Getter implementation for a vertex as a point
+template <typename T>
+BasicPoint<T> BasicGeometryStore<T>::getPoint(int vertex) const
+{
+    return BasicPoint<T>(xs[vertex], ys[vertex]);
+}
+
+// Getter implementations for the raw coordinate arrays
+template <typename T>
+T* BasicGeometryStore<T>::getXs()
+{
+    return xs.data();
+}
+
+template <typename T>
+T* BasicGeometryStore<T>::getYs()
+{
+    return ys.data();
+}
+
+template <typename T>
+const T* BasicGeometryStore<T>::getXs() const
+{
+    return xs.data();
+}
+
+template <typename T>
+const T* BasicGeometryStore<T>::getYs() const
+{
+    return ys.data();
+}
+
+/*
+ * Mark a vertex as hidden inside another obstacle.
+ *
+ * @param vertex - The id of the vertex.
+ */
+template <typename T>
+void BasicGeometryStore<T>::hide(int vertex)
+{
+    hidden[vertex] = true;
+}
+
+/*
+ * Check if a vertex is hidden inside another obstacle.
+ *
+ * @param vertex - The id of the vertex.
+ *
+ * @return True if the vertex was hidden, false otherwise.
+ */
+template <typename T>
+bool BasicGeometryStore<T>::isHidden(int vertex) const
+{
+    return hidden[vertex];
+}
+
+/*
+ * Mark a polygon as merged into another obstacle that contains it.
+ * All of its vertices are hidden and its edges no longer block any line of sight.
+ *
+ * @param polygon - The index of the polygon.
+ */
+template <typename T>
+void BasicGeometryStore<T>::setAbsorbed(int polygon)
+{
+    std::fill(hidden.begin() + getPolygonBegin(polygon), hidden.begin() + getPolygonEnd(polygon), true);
+    absorbed[polygon] = true;
+}
+
+/*
+ * Check if a polygon was merged into another obstacle.
+ *
+ * @param polygon - The index of the polygon.
+ *
+ * @return True if the polygon is absorbed by another obstacle, false otherwise.
+ */
+template <typename T>
+bool BasicGeometryStore<T>::isAbsorbed(int polygon) const
+{
+    return absorbed[polygon];
+}
+
+/*
+ * Get the number of bytes used by the geometry: the coordinates, the flags and the
+ * polygon tables.
+ *
+ * @return The size of the stored arrays in bytes.
+ */
+template <typename T>
+size_t BasicGeometryStore<T>::getMemoryUsage() const
+{
+    return (xs.capacity() + ys.capacity()) * sizeof(T) + hidden.capacity() + absorbed.capacity() +
+        (polygonOffsets.capacity() + polygonNumbers.capacity() + polygonRanks.capacity() + rankedPolygons.capacity()) * sizeof(int);
+}
+
+// Instantiate the stores for both supported scalar types
+template class BasicGeometryStore<float>;
+template class BasicGeometryStore<double>;
@@ -0,0 +1,117 @@
+#pragma once
+#include "Point.h"
+#include "Polygon.h"
+#include <vector>
+#include <cstddef>
+
+/*
+ * Contiguous structure-of-arrays storage for all the geometry of a map.
+ *
+ * Every vertex has an id that indexes the coordinate arrays. The start and end points
+ * occupy the first two ids, followed by the vertices of each polygon in order. The
+ * polygon offset table maps a polygon to its range of vertex ids, so a polygon is
+ * only a view over the shared arrays.
+ */
+template <typename T>
+class BasicGeometryStore {
+private:
+    // Coordinates of every vertex, indexed by vertex id
+    std::vector<T> xs, ys;
+
+    // Vertices that lie inside another obstacle and are not graph nodes
+    std::vector<char> hidden;
+
+    // Id of the first vertex of each polygon, with a final entry past the last vertex
+    std::vector<int> polygonOffsets;
+
+    // Identifier of each polygon as read from the input
+    std::vector<int> polygonNumbers;
+
+    // Polygons that lie inside another obstacle and were merged into it
+    std::vector<char> absorbed;
+
+    // Position of each polygon in the input, and the polygon at each input position
+    std::vector<int> polygonRanks, rankedPolygons;
+
+public:
+    // Vertex ids of the start and end points
+    static const int START_VERTEX = 0;
+    static const int END_VERTEX = 1;
+
+    // Constructor
+    BasicGeometryStore();
+
+    // Remove all geometry and set the start and end points
+    void reset(const BasicPoint<T>& start, const BasicPoint<T>& end);
+
+    // Reserve space for the given number of polygon vertices
+    void reserve(int numPolygons, int numPoints);
+
+    // Start a new polygon, following vertices are added to it
+    void beginPolygon(int number);
+
+    // Add a vertex to the last polygon
+    void addPoint(T x, T y);
+
+    // Keep only the first vertices of each polygon and close the gaps between them
+    void truncatePolygons(const std::vector<int>& sizes);
+
+    // Move the polygons into a new order, keeping the vertices of each polygon contiguous
+    void reorderPolygons(const std::vector<int>& order);
+
+    // Get the number of vertices, including the start and end points
+    int getNumVertices() const;
+
+    // Get the number of polygons
+    int getNumPolygons() const;
+
+    // Get the id of the first vertex of a polygon
+    int getPolygonBegin(int polygon) const;
+
+    // Get the id past the last vertex of a polygon
+    int getPolygonEnd(int polygon) const;
+
+    // Get a view of a polygon
+    BasicPolygon<T> getPolygon(int polygon) const;
+
+    // Get the identifier of a polygon as read from the input
+    int getPolygonNumber(int polygon) const;
+
+    // Get the position of a polygon in the input
+    int getPolygonRank(int polygon) const;
+
+    // Get the polygon at a position in the input
+    int getRankedPolygon(int rank) const;
+
+    // Get the polygon a vertex belongs to, -1 for the start and end points
+    int getVertexPolygon(int vertex) const;
+
+    // Getters for the coordinates of a vertex
+    T getX(int vertex) const;
+    T getY(int vertex) const;
+    BasicPoint<T> getPoint(int vertex) const;
+
+    // Getters for the raw coordinate arrays
+    T* getXs();
+    T* getYs();
+    const T* getXs() const;
+    const T* getYs() const;
+
+    // Mark a vertex as hidden inside another obstacle
+    void hide(int vertex);
+
+    // Check if a vertex is hidden inside another obstacle
+    bool isHidden(int vertex) const;
+
+    // Mark a polygon as merged into another obstacle, hiding all of its vertices
+    void setAbsorbed(int polygon);
+
+    // Check if a polygon was merged into another obstacle
+    bool isAbsorbed(int polygon) const;
+
+    // Get the number of bytes used by the geometry
+    size_t getMemoryUsage() const;
+};
+
+// A geometry store with the scalar type of the build
+typedef BasicGeometryStore<Scalar> GeometryStore;
@@ -0,0 +1,232 @@
+#pragma once
+#include "AStar.h"
+#include <set>
+#include <vector>
+
+/*
+ * A route as a compact sequence of node ids, with its length.
+ */
+struct Route
+{
+    std::vector<int> vertices;
+    double length;
+};
+
+/*
+ * A* search state reused by all the spur searches of Yen's algorithm.
+ *
+ * The arrays are allocated once. Each search gets a new generation number, and a node
+ * whose stamp is older than the current generation is treated as unvisited, so starting
+ * a search costs nothing for the nodes it never reaches. The nodes of the root path are
+ * removed by stamping them, and the edges leaving the spur node that earlier routes
+ * already took are listed in removedTargets.
+ */
+template <typename Graph, typename Heuristic>
+class SpurSearch {
+private:
+    typedef SearchCost<Heuristic> Cost;
+
+    const Graph& graph;
+    int goal;
+    Heuristic heuristic;
+
+    std::vector<Cost> gScore;
+    std::vector<int> cameFrom;
+    std::vector<unsigned int> visitedStamp, processedStamp, removedStamp;
+    unsigned int generation;
+
+    bool isVisited(int node) const
+    {
+        return visitedStamp[node] == generation;
+    }
+
+public:
+    // Edges from the spur node that the next search may not take
+    std::vector<int> removedTargets;
+
+    SpurSearch(const Graph& graph, int goal, Heuristic heuristic)
+        : graph(graph), goal(goal), heuristic(heuristic), generation(0)
+    {
+        int numVertices = graph.getNumVertices();
+        gScore.assign(numVertices, 0);
+        cameFrom.assign(numVertices, -1);
+        visitedStamp.assign(numVertices, 0);
+        processedStamp.assign(numVertices, 0);
+        removedStamp.assign(numVertices, 0);
+    }
+
+    // Start a new search: all nodes are unvisited and none is removed
+    void reset()
+    {
+        generation++;
+        removedTargets.clear();
+    }
+
+    // Remove a node from the graph until the next reset
+    void removeNode(int node)
+    {
+        removedStamp[node] = generation;
+    }
+
+    /*
+     * Find the shortest path from a spur node to the goal in the graph without the
+     * removed nodes and edges.
+     *
+     * @param spur - The node to start from.
+     * @param length - Set to the length of the path.
+     *
+     * @return The node ids of the path, empty if there is none.
+     */
+    std::vector<int> search(int spur, Cost& length)
+    {
+        std::priority_queue<std::pair<Cost, int>, std::vector<std::pair<Cost, int>>, std::greater<>> openSet;
+
+        gScore[spur] = 0;
+        cameFrom[spur] = -1;
+        visitedStamp[spur] = generation;
+        openSet.push({ heuristic(spur), spur });
+
+        while (!openSet.empty()) {
+            int current = openSet.top().second;
+            openSet.pop();
+
+            // Skip if the node is already processed
+            if (processedStamp[current] == generation) {
+                continue;
+            }
+
+            processedStamp[current] = generation;
+
+            if (current == goal) {
+                length = gScore[goal];
+
+                std::vector<int> path;
+                for (int node = goal; node != -1; node = cameFrom[node]) {
+                    path.push_back(node);
+                }
+                std::reverse(path.begin(), path.end());
+                return path;
+            }
+
+            graph.forEachNeighbor(current, [&](int neighbor, Cost distanceToNeighbor) {
+                if (removedStamp[neighbor] == generation || (current == spur &&
+                    std::find(removedTargets.begin(), removedTargets.end(), neighbor) != removedTargets.end())) {
+                    return;
+                }
+
+                Cost tentativeGScore = gScore[current] + distanceToNeighbor;
+
+                if (!isVisited(neighbor) || tentativeGScore < gScore[neighbor]) {
+                    visitedStamp[neighbor] = generation;
+                    cameFrom[neighbor] = current;
+                    gScore[neighbor] = tentativeGScore;
+                    openSet.push({ tentativeGScore + heuristic(neighbor), neighbor });
+                }
+            });
+        }
+
+        return std::vector<int>();
+    }
+};
+
+/*
+ * Find the k shortest loopless routes between two nodes with Yen's algorithm.
+ *
+ * Each route after the first deviates from a previous route at a spur node: the route
+ * follows a previous route up to the spur node (the root), then takes the shortest path
+ * to the goal that avoids the root nodes and the edges previous routes with the same
+ * root took from the spur node. All the spur searches share one search state.
+ *
+ * @param graph - The graph to search, as for aStar().
+ * @param start - The starting node id.
+ * @param goal - The goal node id.
+ * @param k - The number of routes to find.
+ * @param heuristic - Estimate of the distance from a node to the goal, must not overestimate.
+ *
+ * @return Up to k routes, shortest first.
+ */
+template <typename Graph, typename Heuristic>
+std::vector<Route> kShortestPaths(const Graph& graph, int start, int goal, int k, Heuristic heuristic)
+{
+    typedef SearchCost<Heuristic> Cost;
+
+    std::vector<Route> routes;
+    if (k <= 0) {
+        return routes;
+    }
+
+    SpurSearch<Graph, Heuristic> spurSearch(graph, goal, heuristic);
+
+    // Length of each route up to each of its nodes, to price the roots
+    std::vector<std::vector<Cost>> prefixLengths;
+
+    // Candidate routes by length, and every route already found or queued
+    std::set<std::pair<Cost, std::vector<int>>> candidates;
+    std::set<std::vector<int>> knownRoutes;
+
+    spurSearch.reset();
+    Cost length;
+    std::vector<int> first = spurSearch.search(start, length);
+    if (first.empty()) {
+        return routes;
+    }
+    candidates.insert({ length, first });
+    knownRoutes.insert(first);
+
+    while ((int)routes.size() < k && !candidates.empty()) {
+        Route route = { candidates.begin()->second, candidates.begin()->first };
+        candidates.erase(candidates.begin());
+
+        // Length of the route up to each node, from the edge lengths of the graph
+        std::vector<Cost> prefix(1, 0);
+        for (size_t i = 0; i + 1 < route.vertices.size(); i++) {
+            Cost edgeLength = 0;
+            graph.forEachNeighbor(route.vertices[i], [&](int neighbor, Cost distanceToNeighbor) {
+                if (neighbor == route.vertices[i + 1]) {
+                    edgeLength = distanceToNeighbor;
+                }
+            });
+            prefix.push_back(prefix.back() + edgeLength);
+        }
+
+        routes.push_back(route);
+        prefixLengths.push_back(prefix);
+        if ((int)routes.size() == k) {
+            break;
+        }
+
+        // Deviate from the new route at each of its nodes
+        const std::vector<int>& previous = routes.back().vertices;
+        for (size_t spurIndex = 0; spurIndex + 1 < previous.size(); spurIndex++) {
+            int spur = previous[spurIndex];
+            spurSearch.reset();
+
+            // Remove the edges taken from the spur node by routes sharing this root
+            for (const Route& other : routes) {
+                if (other.vertices.size() > spurIndex + 1 &&
+                    std::equal(previous.begin(), previous.begin() + spurIndex + 1, other.vertices.begin())) {
+                    spurSearch.removedTargets.push_back(other.vertices[spurIndex + 1]);
+                }
+            }
+
+            // Remove the root nodes so the route stays loopless
+            for (size_t i = 0; i < spurIndex; i++) {
+                spurSearch.removeNode(previous[i]);
+            }
+
+            Cost spurLength;
+            std::vector<int> spurPath = spurSearch.search(spur, spurLength);
+            if (spurPath.empty()) {
+                continue;
+            }
+
+            std::vector<int> candidate(previous.begin(), previous.begin() + spurIndex);
+            candidate.insert(candidate.end(), spurPath.begin(), spurPath.end());
+            if (knownRoutes.insert(candidate).second) {
+                candidates.insert({ prefixLengths.back()[spurIndex] + spurLength, candidate });
+            }
+        }
+    }
+
+    return routes;
+}
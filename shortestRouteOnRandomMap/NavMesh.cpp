@@ -0,0 +1,1098 @@
+#include "NavMesh.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <queue>
+#include <functional>
+
+namespace {
+
+// Maximum nesting of constraint splits at collinear vertices and crossing constraints
+const int maxConstraintDepth = 64;
+
+/*
+ * Run the funnel algorithm over a channel of portals and return the corners of the
+ * path found so far. Every shortest path from the start to a point of the last portal
+ * passes through the last corner, the apex of the funnel. The apex can restart on a
+ * portal that shares its vertex, which finds the same corner again; it is kept once.
+ *
+ * @param portals - The edges crossed by the channel as (left, right) pairs when walking
+ *                  from the start, starting with (start, start).
+ *
+ * @return The start point followed by the corners of the path.
+ */
+std::vector<Point> funnelCorners(const std::vector<std::pair<Point, Point>>& portals)
+{
+    Point apex = portals[0].first;
+    Point left = portals[0].first;
+    Point right = portals[0].second;
+    int apexIndex = 0, leftIndex = 0, rightIndex = 0;
+
+    std::vector<Point> path;
+    path.push_back(apex);
+
+    for (int i = 1; i < (int)portals.size(); i++)
+    {
+        const Point& portalLeft = portals[i].first;
+        const Point& portalRight = portals[i].second;
+
+        // Try to narrow the funnel from the right side
+        if (orient2d(apex, right, portalRight) >= 0)
+        {
+            if (apex == right || orient2d(apex, left, portalRight) < 0)
+            {
+                right = portalRight;
+                rightIndex = i;
+            }
+            else
+            {
+                // The right side crossed the left side, the left point is a corner of the path
+                if (!(path.back() == left))
+                {
+                    path.push_back(left);
+                }
+                apex = left;
+                apexIndex = leftIndex;
+                right = apex;
+                rightIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+
+        // Try to narrow the funnel from the left side
+        if (orient2d(apex, left, portalLeft) <= 0)
+        {
+            if (apex == left || orient2d(apex, right, portalLeft) > 0)
+            {
+                left = portalLeft;
+                leftIndex = i;
+            }
+            else
+            {
+                // The left side crossed the right side, the right point is a corner of the path
+                if (!(path.back() == right))
+                {
+                    path.push_back(right);
+                }
+                apex = right;
+                apexIndex = rightIndex;
+                left = apex;
+                leftIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+    }
+
+    return path;
+}
+
+/*
+ * Straighten a channel of portals with the funnel algorithm.
+ *
+ * @param portals - The edges crossed by the channel as (left, right) pairs when walking
+ *                  from start to goal, starting with (start, start) and ending with (goal, goal).
+ *
+ * @return The shortest path through the channel.
+ */
+std::vector<Point> stringPull(const std::vector<std::pair<Point, Point>>& portals)
+{
+    std::vector<Point> path = funnelCorners(portals);
+
+    const Point& goal = portals.back().first;
+    if (!(path.back() == goal))
+    {
+        path.push_back(goal);
+    }
+
+    return path;
+}
+
+// Length of a polyline
+double pathLength(const std::vector<Point>& path)
+{
+    double length = 0;
+    for (size_t i = 1; i < path.size(); i++)
+    {
+        length += path[i - 1].calculateDistance(path[i]);
+    }
+    return length;
+}
+
+// Distance from a point to a segment
+double distanceToSegment(const Point& point, const Point& a, const Point& b)
+{
+    double dx = (double)b.getX() - a.getX(), dy = (double)b.getY() - a.getY();
+    double lengthSquared = dx * dx + dy * dy;
+    double t = 0;
+    if (lengthSquared > 0)
+    {
+        t = ((point.getX() - a.getX()) * dx + (point.getY() - a.getY()) * dy) / lengthSquared;
+        t = std::min(1.0, std::max(0.0, t));
+    }
+    return std::hypot(a.getX() + t * dx - point.getX(), a.getY() + t * dy - point.getY());
+}
+
+// Twice the signed area of a hull, positive if its vertices are counter-clockwise
+double hullArea(const GeometryStore& store, int polygon)
+{
+    int begin = store.getPolygonBegin(polygon), end = store.getPolygonEnd(polygon);
+    double area = 0;
+    for (int vertex = begin; vertex < end; vertex++)
+    {
+        int next = (vertex + 1 < end) ? vertex + 1 : begin;
+        area += (double)store.getX(vertex) * store.getY(next) - (double)store.getX(next) * store.getY(vertex);
+    }
+    return area;
+}
+
+// A channel of the search: the triangles crossed from the start triangle, as a tree of portals
+struct ChannelNode
+{
+    // The edge crossed into the triangle (3 * t + k for edge k of triangle t), -1 for the start
+    int portal;
+    int triangle;
+    int parent;
+    double cost;
+};
+
+}
+
+// Constructor implementation
+NavMesh::NavMesh() : lastTriangle(0) {
+}
+
+/*
+ * Build the mesh: triangulate a box around the map, insert every hull vertex, then
+ * insert every hull edge as a constrained edge and classify the triangles.
+ *
+ * @param store - The store holding the convex hulls and the start and end points.
+ */
+void NavMesh::build(const GeometryStore& store)
+{
+    xs.clear();
+    ys.clear();
+    vertexTriangles.clear();
+    triangles.clear();
+    neighbors.clear();
+    constrainedEdges.clear();
+    lastTriangle = 0;
+
+    // Box around all the vertices, with a margin so no vertex lies on its boundary
+    double minX = std::numeric_limits<double>::infinity(), minY = minX;
+    double maxX = -minX, maxY = -minX;
+    for (int vertex = 0; vertex < store.getNumVertices(); vertex++)
+    {
+        minX = std::min<double>(minX, store.getX(vertex));
+        minY = std::min<double>(minY, store.getY(vertex));
+        maxX = std::max<double>(maxX, store.getX(vertex));
+        maxY = std::max<double>(maxY, store.getY(vertex));
+    }
+    double margin = std::max(1.0, 0.1 * std::max(maxX - minX, maxY - minY));
+    minX -= margin;
+    minY -= margin;
+    maxX += margin;
+    maxY += margin;
+
+    int corner0 = addVertex(minX, minY);
+    int corner1 = addVertex(maxX, minY);
+    int corner2 = addVertex(maxX, maxY);
+    int corner3 = addVertex(minX, maxY);
+    int lower = addTriangle(corner0, corner1, corner2);
+    int upper = addTriangle(corner0, corner2, corner3);
+    setTriangle(lower, corner0, corner1, corner2, -1, -1, upper);
+    setTriangle(upper, corner0, corner2, corner3, lower, -1, -1);
+
+    // Insert the vertices of every hull that was not merged into another one
+    std::vector<int> meshVertices(store.getNumVertices(), -1);
+    for (int polygon = 0; polygon < store.getNumPolygons(); polygon++)
+    {
+        if (store.isAbsorbed(polygon))
+        {
+            continue;
+        }
+
+        for (int vertex = store.getPolygonBegin(polygon); vertex < store.getPolygonEnd(polygon); vertex++)
+        {
+            meshVertices[vertex] = insertPoint(store.getX(vertex), store.getY(vertex));
+        }
+    }
+
+    // Insert the hull edges as constraints
+    for (int polygon = 0; polygon < store.getNumPolygons(); polygon++)
+    {
+        int begin = store.getPolygonBegin(polygon);
+        int size = store.getPolygonEnd(polygon) - begin;
+        if (store.isAbsorbed(polygon) || size < 2)
+        {
+            continue;
+        }
+
+        // A hull of two points is a single segment with no inside
+        int numEdges = (size == 2) ? 1 : size;
+        int weight = (size == 2) ? 0 : (hullArea(store, polygon) > 0 ? 1 : -1);
+        for (int i = 0; i < numEdges; i++)
+        {
+            insertConstraint(meshVertices[begin + i], meshVertices[begin + (i + 1) % size], weight, 0);
+        }
+    }
+
+    classifyTriangles();
+}
+
+/*
+ * Add a vertex to the mesh.
+ *
+ * @param x, y - The coordinates of the vertex.
+ *
+ * @return The id of the new vertex.
+ */
+int NavMesh::addVertex(double x, double y)
+{
+    xs.push_back(x);
+    ys.push_back(y);
+    vertexTriangles.push_back(-1);
+    return xs.size() - 1;
+}
+
+/*
+ * Add a triangle to the mesh, its neighbors are set with setTriangle().
+ *
+ * @param a, b, c - The vertices of the triangle in counter-clockwise order.
+ *
+ * @return The id of the new triangle.
+ */
+int NavMesh::addTriangle(int a, int b, int c)
+{
+    triangles.insert(triangles.end(), { a, b, c });
+    neighbors.insert(neighbors.end(), { -1, -1, -1 });
+    return triangles.size() / 3 - 1;
+}
+
+/*
+ * Set the vertices and neighbors of a triangle.
+ *
+ * @param triangle - The id of the triangle.
+ * @param a, b, c - The vertices of the triangle in counter-clockwise order.
+ * @param nab, nbc, nca - The neighbors across the edges (a, b), (b, c) and (c, a).
+ */
+void NavMesh::setTriangle(int triangle, int a, int b, int c, int nab, int nbc, int nca)
+{
+    triangles[3 * triangle] = a;
+    triangles[3 * triangle + 1] = b;
+    triangles[3 * triangle + 2] = c;
+    neighbors[3 * triangle] = nab;
+    neighbors[3 * triangle + 1] = nbc;
+    neighbors[3 * triangle + 2] = nca;
+    vertexTriangles[a] = triangle;
+    vertexTriangles[b] = triangle;
+    vertexTriangles[c] = triangle;
+}
+
+/*
+ * Replace a neighbor of a triangle.
+ *
+ * @param triangle - The id of the triangle, may be -1 for the outside of the mesh.
+ * @param oldNeighbor - The neighbor to replace.
+ * @param newNeighbor - The neighbor to put in its place.
+ */
+void NavMesh::replaceNeighbor(int triangle, int oldNeighbor, int newNeighbor)
+{
+    if (triangle < 0)
+    {
+        return;
+    }
+
+    for (int edge = 0; edge < 3; edge++)
+    {
+        if (neighbors[3 * triangle + edge] == oldNeighbor)
+        {
+            neighbors[3 * triangle + edge] = newNeighbor;
+            return;
+        }
+    }
+}
+
+/*
+ * Find the edge of a triangle going from one vertex to another.
+ *
+ * @param triangle - The id of the triangle.
+ * @param a, b - The vertices of the edge.
+ *
+ * @return The index of the edge, -1 if the triangle has no edge from a to b.
+ */
+int NavMesh::findEdge(int triangle, int a, int b) const
+{
+    for (int edge = 0; edge < 3; edge++)
+    {
+        if (triangles[3 * triangle + edge] == a && triangles[3 * triangle + (edge + 1) % 3] == b)
+        {
+            return edge;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Find the triangle that has an edge going from one vertex to another, by
+ * turning around the first vertex.
+ *
+ * @param a, b - The vertices of the edge.
+ *
+ * @return The id of the triangle, -1 if there is no such edge.
+ */
+int NavMesh::findTriangleWithEdge(int a, int b) const
+{
+    int first = vertexTriangles[a];
+
+    // Turn counter-clockwise around a
+    int triangle = first;
+    do
+    {
+        int corner = (triangles[3 * triangle] == a) ? 0 : (triangles[3 * triangle + 1] == a) ? 1 : 2;
+        if (triangles[3 * triangle + (corner + 1) % 3] == b)
+        {
+            return triangle;
+        }
+        triangle = neighbors[3 * triangle + (corner + 2) % 3];
+    } while (triangle >= 0 && triangle != first);
+
+    if (triangle == first)
+    {
+        return -1;
+    }
+
+    // Reached the boundary, turn clockwise around a from the first triangle
+    triangle = first;
+    while (triangle >= 0)
+    {
+        int corner = (triangles[3 * triangle] == a) ? 0 : (triangles[3 * triangle + 1] == a) ? 1 : 2;
+        if (triangles[3 * triangle + (corner + 1) % 3] == b)
+        {
+            return triangle;
+        }
+        triangle = neighbors[3 * triangle + corner];
+        if (triangle == first)
+        {
+            break;
+        }
+    }
+
+    return -1;
+}
+
+// Orientation of three mesh vertices
+double NavMesh::orient(int a, int b, int c) const
+{
+    return orient2d(xs[a], ys[a], xs[b], ys[b], xs[c], ys[c]);
+}
+
+// Orientation of two mesh vertices and a point
+double NavMesh::orient(int a, int b, double x, double y) const
+{
+    return orient2d(xs[a], ys[a], xs[b], ys[b], x, y);
+}
+
+/*
+ * Find the triangle containing a point with a stochastic walk, which always terminates
+ * in a constrained triangulation.
+ *
+ * @param x, y - The coordinates of the point.
+ * @param onEdge - Set to the edge of the triangle the point lies on, -1 if none.
+ * @param onVertex - Set to the vertex the point coincides with, -1 if none.
+ *
+ * @return The id of the triangle, -1 if the point is outside the mesh.
+ */
+int NavMesh::locate(double x, double y, int& onEdge, int& onVertex) const
+{
+    int triangle = (lastTriangle < getNumTriangles()) ? lastTriangle : 0;
+    unsigned int random = 12345;
+    onEdge = -1;
+    onVertex = -1;
+
+    while (true)
+    {
+        random = random * 1103515245u + 12345u;
+        int first = (random >> 16) % 3;
+        int next = -1;
+        int zeroEdges[3];
+        int numZero = 0;
+
+        for (int i = 0; i < 3; i++)
+        {
+            int edge = (first + i) % 3;
+            double side = orient(triangles[3 * triangle + edge], triangles[3 * triangle + (edge + 1) % 3], x, y);
+            if (side < 0)
+            {
+                next = neighbors[3 * triangle + edge];
+                break;
+            }
+            if (side == 0)
+            {
+                zeroEdges[numZero++] = edge;
+            }
+        }
+
+        if (next == -1 && numZero < 3)
+        {
+            bool outside = false;
+            for (int edge = 0; edge < 3; edge++)
+            {
+                if (orient(triangles[3 * triangle + edge], triangles[3 * triangle + (edge + 1) % 3], x, y) < 0)
+                {
+                    outside = true;
+                }
+            }
+            if (outside)
+            {
+                return -1;
+            }
+
+            if (numZero == 1)
+            {
+                onEdge = zeroEdges[0];
+            }
+            else if (numZero == 2)
+            {
+                // The point is the vertex shared by both edges
+                int shared = (zeroEdges[0] + 1) % 3 == zeroEdges[1] ? zeroEdges[1] : zeroEdges[0];
+                onVertex = triangles[3 * triangle + shared];
+            }
+            return triangle;
+        }
+
+        triangle = next;
+    }
+}
+
+/*
+ * Insert a point into the triangulation and restore the Delaunay property.
+ *
+ * @param x, y - The coordinates of the point.
+ *
+ * @return The id of the vertex at the point, -1 if it is outside the mesh.
+ */
+int NavMesh::insertPoint(double x, double y)
+{
+    int onEdge, onVertex;
+    int triangle = locate(x, y, onEdge, onVertex);
+
+    if (triangle < 0)
+    {
+        return -1;
+    }
+    if (onVertex >= 0)
+    {
+        return onVertex;
+    }
+
+    int vertex = addVertex(x, y);
+    if (onEdge >= 0)
+    {
+        splitEdge(triangle, onEdge, vertex);
+    }
+    else
+    {
+        splitTriangle(triangle, vertex);
+    }
+    lastTriangle = vertexTriangles[vertex];
+
+    return vertex;
+}
+
+/*
+ * Split a triangle into three around a vertex inside it.
+ *
+ * @param triangle - The id of the triangle.
+ * @param vertex - The new vertex.
+ */
+void NavMesh::splitTriangle(int triangle, int vertex)
+{
+    int a = triangles[3 * triangle], b = triangles[3 * triangle + 1], c = triangles[3 * triangle + 2];
+    int nab = neighbors[3 * triangle], nbc = neighbors[3 * triangle + 1], nca = neighbors[3 * triangle + 2];
+
+    int second = addTriangle(b, c, vertex);
+    int third = addTriangle(c, a, vertex);
+    setTriangle(triangle, a, b, vertex, nab, second, third);
+    setTriangle(second, b, c, vertex, nbc, third, triangle);
+    setTriangle(third, c, a, vertex, nca, triangle, second);
+    replaceNeighbor(nbc, triangle, second);
+    replaceNeighbor(nca, triangle, third);
+
+    std::vector<int> stack = { triangle, second, third };
+    legalize(stack, vertex);
+}
+
+/*
+ * Split an edge and the two triangles beside it at a vertex on the edge.
+ *
+ * @param triangle - The id of a triangle with the edge.
+ * @param edge - The index of the edge in the triangle.
+ * @param vertex - The new vertex.
+ */
+void NavMesh::splitEdge(int triangle, int edge, int vertex)
+{
+    int a = triangles[3 * triangle + edge];
+    int b = triangles[3 * triangle + (edge + 1) % 3];
+    int c = triangles[3 * triangle + (edge + 2) % 3];
+    int other = neighbors[3 * triangle + edge];
+    int nbc = neighbors[3 * triangle + (edge + 1) % 3];
+    int nca = neighbors[3 * triangle + (edge + 2) % 3];
+
+    // A constrained edge stays constrained in both halves, with the same weight
+    if (isConstrained(a, b))
+    {
+        int weight = getConstraintWeight(a, b);
+        constrainedEdges.erase(edgeKey(a, b));
+        setConstrained(a, vertex, weight);
+        setConstrained(vertex, b, weight);
+    }
+
+    std::vector<int> stack;
+    if (other < 0)
+    {
+        int second = addTriangle(vertex, b, c);
+        setTriangle(triangle, a, vertex, c, -1, second, nca);
+        setTriangle(second, vertex, b, c, -1, nbc, triangle);
+        replaceNeighbor(nbc, triangle, second);
+        stack = { triangle, second };
+    }
+    else
+    {
+        int otherEdge = findEdge(other, b, a);
+        int d = triangles[3 * other + (otherEdge + 2) % 3];
+        int nad = neighbors[3 * other + (otherEdge + 1) % 3];
+        int ndb = neighbors[3 * other + (otherEdge + 2) % 3];
+
+        int second = addTriangle(vertex, b, c);
+        int otherSecond = addTriangle(vertex, a, d);
+        setTriangle(triangle, a, vertex, c, otherSecond, second, nca);
+        setTriangle(second, vertex, b, c, other, nbc, triangle);
+        setTriangle(other, b, vertex, d, second, otherSecond, ndb);
+        setTriangle(otherSecond, vertex, a, d, triangle, nad, other);
+        replaceNeighbor(nbc, triangle, second);
+        replaceNeighbor(nad, other, otherSecond);
+        stack = { triangle, second, other, otherSecond };
+    }
+
+    legalize(stack, vertex);
+}
+
+/*
+ * Flip the edge of a triangle, replacing it with the other diagonal of the
+ * quadrilateral formed by the triangle and its neighbor.
+ *
+ * @param triangle - The id of the triangle.
+ * @param edge - The index of the edge in the triangle.
+ */
+void NavMesh::flip(int triangle, int edge)
+{
+    int a = triangles[3 * triangle + edge];
+    int b = triangles[3 * triangle + (edge + 1) % 3];
+    int c = triangles[3 * triangle + (edge + 2) % 3];
+    int other = neighbors[3 * triangle + edge];
+    int otherEdge = findEdge(other, b, a);
+    int d = triangles[3 * other + (otherEdge + 2) % 3];
+
+    int nbc = neighbors[3 * triangle + (edge + 1) % 3];
+    int nca = neighbors[3 * triangle + (edge + 2) % 3];
+    int nad = neighbors[3 * other + (otherEdge + 1) % 3];
+    int ndb = neighbors[3 * other + (otherEdge + 2) % 3];
+
+    setTriangle(triangle, c, a, d, nca, nad, other);
+    setTriangle(other, d, b, c, ndb, nbc, triangle);
+    replaceNeighbor(nad, other, triangle);
+    replaceNeighbor(nbc, triangle, other);
+}
+
+/*
+ * Check if an edge of a triangle satisfies the Delaunay property. Constrained edges
+ * and boundary edges always do.
+ *
+ * @param triangle - The id of the triangle.
+ * @param edge - The index of the edge in the triangle.
+ *
+ * @return True if the edge does not need to be flipped, false otherwise.
+ */
+bool NavMesh::isLocallyDelaunay(int triangle, int edge) const
+{
+    int other = neighbors[3 * triangle + edge];
+    int a = triangles[3 * triangle + edge];
+    int b = triangles[3 * triangle + (edge + 1) % 3];
+    int c = triangles[3 * triangle + (edge + 2) % 3];
+
+    if (other < 0 || isConstrained(a, b))
+    {
+        return true;
+    }
+
+    int d = triangles[3 * other + (findEdge(other, b, a) + 2) % 3];
+    return incircle(xs[a], ys[a], xs[b], ys[b], xs[c], ys[c], xs[d], ys[d]) <= 0;
+}
+
+/*
+ * Flip the edges opposite a new vertex until the triangulation is Delaunay again.
+ *
+ * @param stack - The triangles around the new vertex whose opposite edge must be checked.
+ * @param vertex - The new vertex.
+ */
+void NavMesh::legalize(std::vector<int>& stack, int vertex)
+{
+    while (!stack.empty())
+    {
+        int triangle = stack.back();
+        stack.pop_back();
+
+        int corner = (triangles[3 * triangle] == vertex) ? 0 : (triangles[3 * triangle + 1] == vertex) ? 1 : 2;
+        int edge = (corner + 1) % 3;
+
+        if (!isLocallyDelaunay(triangle, edge))
+        {
+            int other = neighbors[3 * triangle + edge];
+            flip(triangle, edge);
+            stack.push_back(triangle);
+            stack.push_back(other);
+        }
+    }
+}
+
+/*
+ * Insert a constrained edge between two vertices. The edges crossing it are flipped
+ * away, then the Delaunay property is restored around it. The edge is split at
+ * vertices lying on it and at existing constrained edges it crosses.
+ *
+ * @param a, b - The vertices of the edge.
+ * @param weight - The winding weight of the edge from a to b, 1 if an obstacle lies on its left.
+ * @param depth - The number of splits leading to this edge.
+ */
+void NavMesh::insertConstraint(int a, int b, int weight, int depth)
+{
+    if (a == b || a < 0 || b < 0 || depth > maxConstraintDepth)
+    {
+        return;
+    }
+
+    if (findTriangleWithEdge(a, b) >= 0 || findTriangleWithEdge(b, a) >= 0)
+    {
+        setConstrained(a, b, weight);
+        return;
+    }
+
+    // Find the triangle around a that the segment leaves a through
+    int triangle = vertexTriangles[a];
+    int right = -1, left = -1;
+    for (int step = 0; step < getNumTriangles() && right < 0; step++)
+    {
+        int corner = (triangles[3 * triangle] == a) ? 0 : (triangles[3 * triangle + 1] == a) ? 1 : 2;
+        int first = triangles[3 * triangle + (corner + 1) % 3];
+        int second = triangles[3 * triangle + (corner + 2) % 3];
+        double firstSide = orient(a, b, first);
+        double secondSide = orient(a, b, second);
+
+        // A vertex lying on the segment splits it in two
+        for (int vertex : { first, second })
+        {
+            double side = (vertex == first) ? firstSide : secondSide;
+            double forward = (xs[vertex] - xs[a]) * (xs[b] - xs[a]) + (ys[vertex] - ys[a]) * (ys[b] - ys[a]);
+            if (side == 0 && forward > 0)
+            {
+                insertConstraint(a, vertex, weight, depth + 1);
+                insertConstraint(vertex, b, weight, depth + 1);
+                return;
+            }
+        }
+
+        if (firstSide < 0 && secondSide > 0)
+        {
+            right = first;
+            left = second;
+            break;
+        }
+
+        triangle = neighbors[3 * triangle + (corner + 2) % 3];
+        if (triangle < 0)
+        {
+            return;
+        }
+    }
+    if (right < 0)
+    {
+        return;
+    }
+
+    // Walk along the segment and collect the edges it crosses
+    std::deque<std::pair<int, int>> crossed;
+    while (true)
+    {
+        int edge = findEdge(triangle, right, left);
+
+        if (isConstrained(right, left))
+        {
+            // Two constraints cross: split both at their intersection point
+            double startSide = orient(right, left, a);
+            double endSide = orient(right, left, b);
+            double t = startSide / (startSide - endSide);
+            double x = xs[a] + t * (xs[b] - xs[a]);
+            double y = ys[a] + t * (ys[b] - ys[a]);
+
+            int vertex;
+            if (x == xs[right] && y == ys[right])
+            {
+                vertex = right;
+            }
+            else if (x == xs[left] && y == ys[left])
+            {
+                vertex = left;
+            }
+            else
+            {
+                vertex = addVertex(x, y);
+                splitEdge(triangle, edge, vertex);
+            }
+
+            insertConstraint(a, vertex, weight, depth + 1);
+            insertConstraint(vertex, b, weight, depth + 1);
+            return;
+        }
+
+        crossed.push_back({ right, left });
+
+        int other = neighbors[3 * triangle + edge];
+        int far = triangles[3 * other + (findEdge(other, left, right) + 2) % 3];
+        if (far == b)
+        {
+            break;
+        }
+
+        double side = orient(a, b, far);
+        if (side == 0)
+        {
+            insertConstraint(a, far, weight, depth + 1);
+            insertConstraint(far, b, weight, depth + 1);
+            return;
+        }
+        if (side > 0)
+        {
+            left = far;
+        }
+        else
+        {
+            right = far;
+        }
+        triangle = other;
+    }
+
+    // Flip the crossing edges away, re-queueing the ones that cannot be flipped yet
+    std::vector<std::pair<int, int>> newEdges;
+    while (!crossed.empty())
+    {
+        int u = crossed.front().first, v = crossed.front().second;
+        crossed.pop_front();
+
+        int current = findTriangleWithEdge(u, v);
+        int edge = findEdge(current, u, v);
+        int c = triangles[3 * current + (edge + 2) % 3];
+        int other = neighbors[3 * current + edge];
+        int d = triangles[3 * other + (findEdge(other, v, u) + 2) % 3];
+
+        // The quadrilateral is strictly convex if u and v lie on opposite sides of c-d
+        double uSide = orient(c, d, u);
+        double vSide = orient(c, d, v);
+        if ((uSide > 0 && vSide < 0) || (uSide < 0 && vSide > 0))
+        {
+            flip(current, edge);
+            double cSide = orient(a, b, c);
+            double dSide = orient(a, b, d);
+            if ((cSide > 0 && dSide < 0) || (cSide < 0 && dSide > 0))
+            {
+                crossed.push_back({ c, d });
+            }
+            else
+            {
+                newEdges.push_back({ c, d });
+            }
+        }
+        else
+        {
+            crossed.push_back({ u, v });
+        }
+    }
+
+    setConstrained(a, b, weight);
+
+    // Restore the Delaunay property of the new edges
+    bool swapped = true;
+    while (swapped)
+    {
+        swapped = false;
+        for (auto& newEdge : newEdges)
+        {
+            int current = findTriangleWithEdge(newEdge.first, newEdge.second);
+            int edge = findEdge(current, newEdge.first, newEdge.second);
+            if (!isLocallyDelaunay(current, edge))
+            {
+                int c = triangles[3 * current + (edge + 2) % 3];
+                int other = neighbors[3 * current + edge];
+                int d = triangles[3 * other + (findEdge(other, newEdge.second, newEdge.first) + 2) % 3];
+                flip(current, edge);
+                newEdge = { c, d };
+                swapped = true;
+            }
+        }
+    }
+}
+
+/*
+ * Mark the triangles that lie inside an obstacle. Each constrained edge carries the
+ * winding weight of the hull edges along it, so crossing it from its right to its left
+ * side enters that many obstacles. The count is spread from the boundary of the box,
+ * which is outside every obstacle, over the whole mesh in linear time.
+ */
+void NavMesh::classifyTriangles()
+{
+    int numTriangles = getNumTriangles();
+    blocked.assign(numTriangles, false);
+
+    int seed = 0;
+    while (seed < numTriangles && neighbors[3 * seed] >= 0 && neighbors[3 * seed + 1] >= 0 && neighbors[3 * seed + 2] >= 0)
+    {
+        seed++;
+    }
+    if (seed == numTriangles)
+    {
+        return;
+    }
+
+    const int unvisited = std::numeric_limits<int>::min();
+    std::vector<int> depths(numTriangles, unvisited);
+    std::vector<int> queue(1, seed);
+    depths[seed] = 0;
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        int triangle = queue[i];
+        blocked[triangle] = depths[triangle] > 0;
+        for (int edge = 0; edge < 3; edge++)
+        {
+            int other = neighbors[3 * triangle + edge];
+            if (other < 0 || depths[other] != unvisited)
+            {
+                continue;
+            }
+
+            // The triangle is on the left of its counter-clockwise edge, the neighbor on the right
+            int a = triangles[3 * triangle + edge], b = triangles[3 * triangle + (edge + 1) % 3];
+            depths[other] = depths[triangle] - (isConstrained(a, b) ? getConstraintWeight(a, b) : 0);
+            queue.push_back(other);
+        }
+    }
+}
+
+// Key of an undirected edge
+long long NavMesh::edgeKey(int a, int b)
+{
+    return ((long long)std::min(a, b) << 32) | (unsigned int)std::max(a, b);
+}
+
+// Check if an edge is constrained
+bool NavMesh::isConstrained(int a, int b) const
+{
+    return constrainedEdges.count(edgeKey(a, b)) > 0;
+}
+
+// Mark an edge as constrained, adding the winding weight of a hull edge from a to b
+void NavMesh::setConstrained(int a, int b, int weight)
+{
+    constrainedEdges[edgeKey(a, b)] += (a < b) ? weight : -weight;
+}
+
+// Get the winding weight of a constrained edge from a to b
+int NavMesh::getConstraintWeight(int a, int b) const
+{
+    int weight = constrainedEdges.at(edgeKey(a, b));
+    return (a < b) ? weight : -weight;
+}
+
+// Getter implementation for the number of triangles
+int NavMesh::getNumTriangles() const
+{
+    return triangles.size() / 3;
+}
+
+// Check if a triangle is free space
+bool NavMesh::isFree(int triangle) const
+{
+    return !blocked[triangle];
+}
+
+/*
+ * Check if a route can cross an edge of a triangle: the edge must not be an obstacle
+ * edge and must lead to a free triangle.
+ *
+ * @param triangle - The id of the triangle.
+ * @param edge - The index of the edge in the triangle.
+ *
+ * @return True if the edge can be crossed, false otherwise.
+ */
+bool NavMesh::isPassable(int triangle, int edge) const
+{
+    int other = neighbors[3 * triangle + edge];
+    return other >= 0 && !blocked[other] &&
+        !isConstrained(triangles[3 * triangle + edge], triangles[3 * triangle + (edge + 1) % 3]);
+}
+
+// Getter implementation for the neighbor across an edge
+int NavMesh::getNeighbor(int triangle, int edge) const
+{
+    return neighbors[3 * triangle + edge];
+}
+
+// Getter implementation for a vertex of a triangle
+Point NavMesh::getVertex(int triangle, int corner) const
+{
+    int vertex = triangles[3 * triangle + corner];
+    return Point(xs[vertex], ys[vertex]);
+}
+
+/*
+ * Find the free triangle containing a point. A point on the boundary of an obstacle
+ * belongs to a free triangle touching it.
+ *
+ * @param point - The point to locate.
+ *
+ * @return The id of the triangle, -1 if the point is outside the mesh or inside an obstacle.
+ */
+int NavMesh::findTriangle(const Point& point) const
+{
+    int onEdge, onVertex;
+    int triangle = locate(point.getX(), point.getY(), onEdge, onVertex);
+
+    if (triangle < 0 || !blocked[triangle])
+    {
+        return triangle;
+    }
+
+    if (onEdge >= 0)
+    {
+        int other = neighbors[3 * triangle + onEdge];
+        return (other >= 0 && !blocked[other]) ? other : -1;
+    }
+
+    if (onVertex >= 0)
+    {
+        // Look for a free triangle around the vertex
+        for (int candidate = 0; candidate < getNumTriangles(); candidate++)
+        {
+            if (!blocked[candidate] && (triangles[3 * candidate] == onVertex ||
+                triangles[3 * candidate + 1] == onVertex || triangles[3 * candidate + 2] == onVertex))
+            {
+                return candidate;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Find the shortest route between two points. A best-first search over channels of
+ * free triangles runs the funnel algorithm on every channel it extends: the cost of a
+ * channel is the length of its funnel path to the apex plus the distance from the apex
+ * to the last portal, a lower bound on any route through the channel. Each channel
+ * that reaches the goal triangle is straightened, and the search stops when no open
+ * channel can beat the shortest route found. A triangle may be reached by several
+ * channels that pass different obstacles, so the choice between them is made by their
+ * straightened length. Each portal is extended at most maxPortalVisits times.
+ *
+ * @param start - The starting point.
+ * @param goal - The goal point.
+ *
+ * @return The points of the route, empty if there is none.
+ */
+std::vector<Point> NavMesh::findPath(const Point& start, const Point& goal) const
+{
+    const int maxPortalVisits = 4;
+
+    std::vector<Point> path;
+    int startTriangle = findTriangle(start);
+    int goalTriangle = findTriangle(goal);
+
+    if (startTriangle < 0 || goalTriangle < 0)
+    {
+        return path;
+    }
+
+    std::vector<ChannelNode> nodes;
+    nodes.push_back({ -1, startTriangle, -1, 0.0 });
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<>> openSet;
+    openSet.push({ start.calculateDistance(goal), 0 });
+    std::vector<int> portalVisits(3 * getNumTriangles(), 0);
+    double bestLength = std::numeric_limits<double>::infinity();
+
+    std::vector<std::pair<Point, Point>> portals;
+    std::vector<int> channelTriangles;
+    while (!openSet.empty() && openSet.top().first < bestLength)
+    {
+        int current = openSet.top().second;
+        openSet.pop();
+
+        // The portals and triangles of the channel, from the start
+        portals.clear();
+        channelTriangles.clear();
+        for (int node = current; node != -1; node = nodes[node].parent)
+        {
+            channelTriangles.push_back(nodes[node].triangle);
+            if (nodes[node].portal >= 0)
+            {
+                int triangle = nodes[node].portal / 3, edge = nodes[node].portal % 3;
+                portals.push_back({ getVertex(triangle, (edge + 1) % 3), getVertex(triangle, edge) });
+            }
+        }
+        portals.push_back({ start, start });
+        std::reverse(portals.begin(), portals.end());
+
+        int triangle = nodes[current].triangle;
+        if (triangle == goalTriangle)
+        {
+            // The goal triangle is convex, so the route goes straight to the goal from its portal
+            portals.push_back({ goal, goal });
+            std::vector<Point> route = stringPull(portals);
+            double length = pathLength(route);
+            if (length < bestLength)
+            {
+                bestLength = length;
+                path = route;
+            }
+            continue;
+        }
+
+        for (int edge = 0; edge < 3; edge++)
+        {
+            int neighbor = getNeighbor(triangle, edge);
+            int portal = 3 * triangle + edge;
+            if (!isPassable(triangle, edge) || portalVisits[portal] >= maxPortalVisits ||
+                std::find(channelTriangles.begin(), channelTriangles.end(), neighbor) != channelTriangles.end())
+            {
+                continue;
+            }
+            portalVisits[portal]++;
+
+            Point left = getVertex(triangle, (edge + 1) % 3), right = getVertex(triangle, edge);
+            portals.push_back({ left, right });
+            std::vector<Point> corners = funnelCorners(portals);
+            portals.pop_back();
+
+            double cost = pathLength(corners) + distanceToSegment(corners.back(), left, right);
+            double estimate = cost + distanceToSegment(goal, left, right);
+            if (estimate < bestLength)
+            {
+                nodes.push_back({ portal, neighbor, current, cost });
+                openSet.push({ estimate, (int)nodes.size() - 1 });
+            }
+        }
+    }
+
+    return path;
+}
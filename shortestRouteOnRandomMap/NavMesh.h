@@ -0,0 +1,100 @@
+#pragma once
+#include "Point.h"
+#include "GeometryStore.h"
+#include <vector>
+#include <unordered_map>
+
+/*
+ * Navigation mesh engine: a constrained Delaunay triangulation of the map.
+ *
+ * The triangulation covers a box around the map. Every convex hull edge is a
+ * constrained edge, so each triangle lies either inside an obstacle or in free space.
+ * A route is found by a best-first search over channels of free triangles, ordered by
+ * the funnel algorithm's length of each channel. Each channel is straightened with the
+ * funnel algorithm. The search keeps a few channels per portal, not all of them, so
+ * the route is not guaranteed to be the shortest one.
+ *
+ * The mesh takes memory linear in the number n of hull vertices, unlike the line of
+ * sight graph, which needs quadratic memory. Each vertex is located by a walk from the
+ * previous one: the walk is short within a hull but crosses about sqrt(n) triangles
+ * between hulls far apart, so building takes O(n + P sqrt(n)) expected time for P hulls
+ * in random order. Classifying the triangles is linear.
+ */
+class NavMesh {
+private:
+    // Coordinates of the mesh vertices
+    std::vector<double> xs, ys;
+
+    // One incident triangle of each vertex
+    std::vector<int> vertexTriangles;
+
+    // The three vertices of each triangle in counter-clockwise order
+    std::vector<int> triangles;
+
+    // The neighbor across edge k (vertex k to vertex k + 1) of each triangle, -1 on the boundary
+    std::vector<int> neighbors;
+
+    // Triangles that lie inside an obstacle
+    std::vector<char> blocked;
+
+    // Constrained edges, keyed by their two vertices, with the winding weight from the lower vertex to the higher one
+    std::unordered_map<long long, int> constrainedEdges;
+
+    // Triangle to start the next point location from
+    int lastTriangle;
+
+    // Mesh construction
+    int addVertex(double x, double y);
+    int addTriangle(int a, int b, int c);
+    void setTriangle(int triangle, int a, int b, int c, int nab, int nbc, int nca);
+    void replaceNeighbor(int triangle, int oldNeighbor, int newNeighbor);
+    int findEdge(int triangle, int a, int b) const;
+    int findTriangleWithEdge(int a, int b) const;
+    int locate(double x, double y, int& onEdge, int& onVertex) const;
+    int insertPoint(double x, double y);
+    void splitTriangle(int triangle, int vertex);
+    void splitEdge(int triangle, int edge, int vertex);
+    void flip(int triangle, int edge);
+    void legalize(std::vector<int>& stack, int vertex);
+    bool isLocallyDelaunay(int triangle, int edge) const;
+    void insertConstraint(int a, int b, int weight, int depth);
+    void classifyTriangles();
+
+    // Constrained edges
+    static long long edgeKey(int a, int b);
+    bool isConstrained(int a, int b) const;
+    void setConstrained(int a, int b, int weight);
+    int getConstraintWeight(int a, int b) const;
+
+    // Orientation of three mesh vertices
+    double orient(int a, int b, int c) const;
+    double orient(int a, int b, double x, double y) const;
+
+public:
+    // Constructor
+    NavMesh();
+
+    // Build the mesh around the convex hulls of a store
+    void build(const GeometryStore& store);
+
+    // Get the number of triangles
+    int getNumTriangles() const;
+
+    // Check if a triangle is free space
+    bool isFree(int triangle) const;
+
+    // Check if the edge of a triangle can be crossed
+    bool isPassable(int triangle, int edge) const;
+
+    // Get the neighbor across an edge of a triangle
+    int getNeighbor(int triangle, int edge) const;
+
+    // Get a vertex of a triangle, corners are numbered counter-clockwise
+    Point getVertex(int triangle, int corner) const;
+
+    // Find the free triangle containing a point, -1 if the point is inside an obstacle
+    int findTriangle(const Point& point) const;
+
+    // Find the shortest route between two points
+    std::vector<Point> findPath(const Point& start, const Point& goal) const;
+};
@@ -0,0 +1,415 @@
+#include "OccupancyGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+
+// Constructor implementation
+OccupancyGrid::OccupancyGrid() : originX(0), originY(0), cellSize(1), width(0), height(0), wordsPerRow(0) {
+}
+
+/*
+ * Rasterise the convex hulls into the grid. The grid covers the bounding box of all
+ * the vertices, including the start and end points.
+ *
+ * @param store - The store holding the convex hulls and the start and end points.
+ * @param resolution - The number of cells along the longer side of the map.
+ */
+void OccupancyGrid::build(const GeometryStore& store, int resolution)
+{
+    double minX = std::numeric_limits<double>::infinity(), minY = minX;
+    double maxX = -minX, maxY = -minX;
+    for (int vertex = 0; vertex < store.getNumVertices(); vertex++)
+    {
+        minX = std::min<double>(minX, store.getX(vertex));
+        minY = std::min<double>(minY, store.getY(vertex));
+        maxX = std::max<double>(maxX, store.getX(vertex));
+        maxY = std::max<double>(maxY, store.getY(vertex));
+    }
+
+    double extent = std::max(maxX - minX, maxY - minY);
+    originX = minX;
+    originY = minY;
+    cellSize = (extent > 0) ? extent / std::max(1, resolution) : 1.0;
+    width = (int)((maxX - minX) / cellSize) + 1;
+    height = (int)((maxY - minY) / cellSize) + 1;
+    wordsPerRow = (width + 63) / 64;
+    bits.assign((size_t)wordsPerRow * height, 0);
+
+    for (int polygon = 0; polygon < store.getNumPolygons(); polygon++)
+    {
+        if (!store.isAbsorbed(polygon))
+        {
+            fillPolygon(store, polygon);
+        }
+    }
+}
+
+/*
+ * Block a run of cells in a row, a whole word at a time.
+ *
+ * @param row - The row of the cells.
+ * @param firstColumn, lastColumn - The first and last blocked columns.
+ */
+void OccupancyGrid::fillRun(int row, int firstColumn, int lastColumn)
+{
+    uint64_t* words = bits.data() + (size_t)row * wordsPerRow;
+    int firstWord = firstColumn / 64, lastWord = lastColumn / 64;
+    uint64_t firstMask = ~0ull << (firstColumn % 64);
+    uint64_t lastMask = ~0ull >> (63 - lastColumn % 64);
+
+    if (firstWord == lastWord)
+    {
+        words[firstWord] |= firstMask & lastMask;
+        return;
+    }
+
+    words[firstWord] |= firstMask;
+    std::fill(words + firstWord + 1, words + lastWord, ~0ull);
+    words[lastWord] |= lastMask;
+}
+
+/*
+ * Rasterise a convex hull with a scanline fill. For each row, the hull edges are
+ * clipped to the horizontal strip of the row and the cells between the leftmost and
+ * rightmost clipped points are blocked.
+ *
+ * @param store - The store holding the hull.
+ * @param polygon - The index of the hull.
+ */
+void OccupancyGrid::fillPolygon(const GeometryStore& store, int polygon)
+{
+    int begin = store.getPolygonBegin(polygon);
+    int end = store.getPolygonEnd(polygon);
+    if (begin == end)
+    {
+        return;
+    }
+
+    const Scalar* xs = store.getXs();
+    const Scalar* ys = store.getYs();
+    double minY = *std::min_element(ys + begin, ys + end);
+    double maxY = *std::max_element(ys + begin, ys + end);
+
+    for (int row = getRow(minY); row <= getRow(maxY); row++)
+    {
+        double stripMin = originY + row * cellSize;
+        double stripMax = stripMin + cellSize;
+        double left = std::numeric_limits<double>::infinity();
+        double right = -left;
+
+        for (int point1 = begin; point1 < end; point1++)
+        {
+            int point2 = (point1 + 1 < end) ? point1 + 1 : begin;
+            double x1 = xs[point1], y1 = ys[point1], x2 = xs[point2], y2 = ys[point2];
+
+            // Part of the edge inside the strip, as a range of the edge parameter
+            double tMin = 0, tMax = 1;
+            if (y1 == y2)
+            {
+                if (y1 < stripMin || y1 > stripMax)
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                double tLow = (stripMin - y1) / (y2 - y1);
+                double tHigh = (stripMax - y1) / (y2 - y1);
+                tMin = std::max(tMin, std::min(tLow, tHigh));
+                tMax = std::min(tMax, std::max(tLow, tHigh));
+                if (tMin > tMax)
+                {
+                    continue;
+                }
+            }
+
+            double xMin = x1 + tMin * (x2 - x1);
+            double xMax = x1 + tMax * (x2 - x1);
+            left = std::min(left, std::min(xMin, xMax));
+            right = std::max(right, std::max(xMin, xMax));
+        }
+
+        if (left <= right)
+        {
+            fillRun(row, getColumn(left), getColumn(right));
+        }
+    }
+}
+
+// Column of an x-coordinate, clamped to the grid
+int OccupancyGrid::getColumn(double x) const
+{
+    return std::min(width - 1, std::max(0, (int)std::floor((x - originX) / cellSize)));
+}
+
+// Row of a y-coordinate, clamped to the grid
+int OccupancyGrid::getRow(double y) const
+{
+    return std::min(height - 1, std::max(0, (int)std::floor((y - originY) / cellSize)));
+}
+
+// Getter implementation for the number of columns
+int OccupancyGrid::getWidth() const
+{
+    return width;
+}
+
+// Getter implementation for the number of rows
+int OccupancyGrid::getHeight() const
+{
+    return height;
+}
+
+/*
+ * Get the number of cells of a grid with the given resolution on a square map. The
+ * longer side gets the resolution plus one cells, so no map needs more.
+ *
+ * @param resolution - The number of cells along the longer side of the map.
+ *
+ * @return The largest number of cells of the grid.
+ */
+int64_t OccupancyGrid::getMaxCells(int resolution)
+{
+    int64_t side = (int64_t)resolution + 1;
+    return side * side;
+}
+
+/*
+ * Check if a cell is blocked.
+ *
+ * @param column, row - The cell.
+ *
+ * @return True if a hull touches the cell or the cell is outside the grid, false otherwise.
+ */
+bool OccupancyGrid::isBlocked(int column, int row) const
+{
+    if (column < 0 || row < 0 || column >= width || row >= height)
+    {
+        return true;
+    }
+    return (bits[(size_t)row * wordsPerRow + column / 64] >> (column % 64)) & 1;
+}
+
+/*
+ * Check if a cell can be crossed. The cells of the start and goal points are exempt,
+ * so a route can leave a point lying on the boundary of an obstacle.
+ *
+ * @param column, row - The cell.
+ * @param exemptA, exemptB - Cell indices (row * width + column) that are always free, -1 for none.
+ *
+ * @return True if the cell is free, false otherwise.
+ */
+bool OccupancyGrid::isFree(int column, int row, int64_t exemptA, int64_t exemptB) const
+{
+    if (column < 0 || row < 0 || column >= width || row >= height)
+    {
+        return false;
+    }
+
+    int64_t cell = (int64_t)row * width + column;
+    return cell == exemptA || cell == exemptB || !isBlocked(column, row);
+}
+
+// Check that a segment crosses only free cells
+bool OccupancyGrid::lineOfSight(const Point& from, const Point& to) const
+{
+    return lineOfSight(from, to, -1, -1);
+}
+
+/*
+ * Check that a segment crosses only free cells by walking every cell it touches.
+ * When the segment passes exactly through a cell corner, both cells beside the corner
+ * must be free.
+ *
+ * @param from, to - The endpoints of the segment.
+ * @param exemptA, exemptB - Cell indices that are always free, -1 for none.
+ *
+ * @return True if every cell touched by the segment is free, false otherwise.
+ */
+bool OccupancyGrid::lineOfSight(const Point& from, const Point& to, int64_t exemptA, int64_t exemptB) const
+{
+    double gridX0 = (from.getX() - originX) / cellSize, gridY0 = (from.getY() - originY) / cellSize;
+    double gridX1 = (to.getX() - originX) / cellSize, gridY1 = (to.getY() - originY) / cellSize;
+    int column = getColumn(from.getX()), row = getRow(from.getY());
+    int endColumn = getColumn(to.getX()), endRow = getRow(to.getY());
+
+    if (!isFree(column, row, exemptA, exemptB))
+    {
+        return false;
+    }
+
+    double dx = gridX1 - gridX0, dy = gridY1 - gridY0;
+    int stepX = (dx > 0) ? 1 : -1, stepY = (dy > 0) ? 1 : -1;
+    const double infinity = std::numeric_limits<double>::infinity();
+    double tDeltaX = (dx != 0) ? std::abs(1 / dx) : infinity;
+    double tDeltaY = (dy != 0) ? std::abs(1 / dy) : infinity;
+    double tMaxX = (dx != 0) ? ((stepX > 0 ? column + 1 : column) - gridX0) / dx : infinity;
+    double tMaxY = (dy != 0) ? ((stepY > 0 ? row + 1 : row) - gridY0) / dy : infinity;
+
+    int steps = std::abs(endColumn - column) + std::abs(endRow - row);
+    while (steps > 0)
+    {
+        if (tMaxX < tMaxY)
+        {
+            column += stepX;
+            tMaxX += tDeltaX;
+            steps--;
+        }
+        else if (tMaxY < tMaxX)
+        {
+            row += stepY;
+            tMaxY += tDeltaY;
+            steps--;
+        }
+        else
+        {
+            // Through a corner: the segment touches both cells beside it
+            if (!isFree(column + stepX, row, exemptA, exemptB) || !isFree(column, row + stepY, exemptA, exemptB))
+            {
+                return false;
+            }
+            column += stepX;
+            row += stepY;
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+            steps -= 2;
+        }
+
+        if (!isFree(column, row, exemptA, exemptB))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Find a route between two points with Theta*: A* over the free cells where a cell
+ * takes the parent of its predecessor as its own parent when it can see it, so the
+ * route is not bound to the grid directions.
+ *
+ * @param start - The starting point.
+ * @param goal - The goal point.
+ *
+ * @return The points of the route, empty if there is none.
+ */
+std::vector<Point> OccupancyGrid::findPath(const Point& start, const Point& goal) const
+{
+    std::vector<Point> path;
+    if (width == 0 || height == 0)
+    {
+        return path;
+    }
+
+    int64_t startCell = (int64_t)getRow(start.getY()) * width + getColumn(start.getX());
+    int64_t goalCell = (int64_t)getRow(goal.getY()) * width + getColumn(goal.getX());
+    int64_t numCells = (int64_t)width * height;
+
+    if (startCell == goalCell)
+    {
+        return { start, goal };
+    }
+
+    // The start and goal cells are placed at the points, the others at their centres
+    auto position = [&](int64_t cell) {
+        if (cell == startCell)
+        {
+            return start;
+        }
+        if (cell == goalCell)
+        {
+            return goal;
+        }
+        return Point(originX + (cell % width + 0.5) * cellSize, originY + (cell / width + 0.5) * cellSize);
+    };
+
+    std::priority_queue<std::pair<double, int64_t>, std::vector<std::pair<double, int64_t>>, std::greater<>> openSet;
+    std::vector<double> gScore(numCells, std::numeric_limits<double>::infinity());
+    std::vector<int64_t> parent(numCells, -1);
+    std::vector<char> processedCells(numCells, false);
+
+    gScore[startCell] = 0;
+    parent[startCell] = startCell;
+    openSet.push({ start.calculateDistance(goal), startCell });
+
+    while (!openSet.empty()) {
+        int64_t current = openSet.top().second;
+        openSet.pop();
+
+        // Skip if the cell is already processed
+        if (processedCells[current]) {
+            continue;
+        }
+
+        processedCells[current] = true;
+
+        if (current == goalCell) {
+            break;
+        }
+
+        int column = (int)(current % width), row = (int)(current / width);
+        Point currentPosition = position(current);
+        Point parentPosition = position(parent[current]);
+
+        for (int offsetY = -1; offsetY <= 1; offsetY++) {
+            for (int offsetX = -1; offsetX <= 1; offsetX++) {
+                int neighborColumn = column + offsetX, neighborRow = row + offsetY;
+                if ((offsetX == 0 && offsetY == 0) || !isFree(neighborColumn, neighborRow, startCell, goalCell)) {
+                    continue;
+                }
+
+                // Diagonal moves may not cut the corner of a blocked cell
+                if (offsetX != 0 && offsetY != 0 &&
+                    (!isFree(column + offsetX, row, startCell, goalCell) || !isFree(column, row + offsetY, startCell, goalCell))) {
+                    continue;
+                }
+
+                int64_t neighbor = (int64_t)neighborRow * width + neighborColumn;
+                if (processedCells[neighbor]) {
+                    continue;
+                }
+
+                Point neighborPosition = position(neighbor);
+                double tentativeGScore;
+                int64_t tentativeParent;
+
+                if (lineOfSight(parentPosition, neighborPosition, startCell, goalCell)) {
+                    // Path 2: straight from the parent of the current cell
+                    tentativeGScore = gScore[parent[current]] + parentPosition.calculateDistance(neighborPosition);
+                    tentativeParent = parent[current];
+                }
+                else {
+                    // Path 1: through the current cell, the start and goal points are not at cell centres
+                    if ((current == startCell || neighbor == goalCell) &&
+                        !lineOfSight(currentPosition, neighborPosition, startCell, goalCell)) {
+                        continue;
+                    }
+                    tentativeGScore = gScore[current] + currentPosition.calculateDistance(neighborPosition);
+                    tentativeParent = current;
+                }
+
+                if (tentativeGScore < gScore[neighbor]) {
+                    gScore[neighbor] = tentativeGScore;
+                    parent[neighbor] = tentativeParent;
+                    openSet.push({ tentativeGScore + neighborPosition.calculateDistance(goal), neighbor });
+                }
+            }
+        }
+    }
+
+    if (!processedCells[goalCell]) {
+        return path;
+    }
+
+    for (int64_t cell = goalCell; cell != startCell; cell = parent[cell]) {
+        path.push_back(position(cell));
+    }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+
+    return path;
+}
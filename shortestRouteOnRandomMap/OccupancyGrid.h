@@ -0,0 +1,68 @@
+#pragma once
+#include "Point.h"
+#include "GeometryStore.h"
+#include <cstdint>
+#include <vector>
+
+/*
+ * Any-angle grid engine: the convex hulls rasterised into a bit-packed occupancy grid,
+ * searched with Theta*.
+ *
+ * A cell is blocked when any part of a hull touches it, so a segment that only crosses
+ * free cells never enters an obstacle. Memory and search time depend on the resolution
+ * only, not on the number of polygons, at the cost of paths that may be slightly longer
+ * than the shortest one and miss passages narrower than a cell.
+ */
+class OccupancyGrid {
+private:
+    // World coordinates of the lower left corner of the grid and the side of a cell
+    double originX, originY, cellSize;
+
+    // Number of columns and rows, and 64 bit words in each row
+    int width, height, wordsPerRow;
+
+    // One bit per cell, set if the cell is blocked
+    std::vector<uint64_t> bits;
+
+    // Block the cells of a row from the first to the last column
+    void fillRun(int row, int firstColumn, int lastColumn);
+
+    // Rasterise a convex hull
+    void fillPolygon(const GeometryStore& store, int polygon);
+
+    // Cell of a point, clamped to the grid
+    int getColumn(double x) const;
+    int getRow(double y) const;
+
+    // Check a cell, the exempt cells are always free
+    bool isFree(int column, int row, int64_t exemptA, int64_t exemptB) const;
+
+    // Check that a segment crosses only free cells
+    bool lineOfSight(const Point& from, const Point& to, int64_t exemptA, int64_t exemptB) const;
+
+public:
+    // Largest number of cells of a grid, the search takes 17 bytes per cell so about 18 GB at most
+    static const int64_t MAX_CELLS = 1LL << 30;
+
+    // Number of cells of a grid with the given resolution on a square map, the largest case
+    static int64_t getMaxCells(int resolution);
+
+    // Constructor
+    OccupancyGrid();
+
+    // Rasterise the convex hulls, the longer side of the map gets the given number of cells
+    void build(const GeometryStore& store, int resolution);
+
+    // Get the size of the grid
+    int getWidth() const;
+    int getHeight() const;
+
+    // Check if a cell is blocked, cells outside the grid are blocked
+    bool isBlocked(int column, int row) const;
+
+    // Check that a segment crosses only free cells
+    bool lineOfSight(const Point& from, const Point& to) const;
+
+    // Find a route between two points with Theta*
+    std::vector<Point> findPath(const Point& start, const Point& goal) const;
+};
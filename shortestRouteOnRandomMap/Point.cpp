@@ -1,55 +1,43 @@
 #include "Point.h"
+#include "Predicates.h"
 #include <cmath>
 
 // Constructor implementation
-Point::Point(double x, double y): x(x), y(y){}
+template <typename T>
+BasicPoint<T>::BasicPoint(T x, T y): x(x), y(y){}
 
 // Getter implementation for x-coordinate
-double Point::getX() const 
+template <typename T>
+T BasicPoint<T>::getX() const 
 {
     return this->x;
 }
 
 // Getter implementation for y-coordinate
-double Point::getY() const 
+template <typename T>
+T BasicPoint<T>::getY() const 
 {
     return this->y;
 }
 
 // Implementation of the equality (==) operator
-bool Point::operator==(const Point& other)const
+template <typename T>
+bool BasicPoint<T>::operator==(const BasicPoint& other)const
 {
     return this->x == other.x && this->y == other.y;
 }
 
-/*
- * Getter for line of sight neighbors and their distances.
- *
- * @return A reference to the vector of neighbor points and distances.
- */
-const std::vector<std::pair<Point*, double>>& Point::getlineOfSight() const {
-    return lineOfSight;
-}
-
-/*
- * Sets a new neighbor in the line of sight with the given distance.
- *
- * @param newNeighbor - The new neighbor point.
- * @param distance - The distance to the new neighbor.
- */
-void Point::setlineOfSight(Point* newNeighbor, double distance) {
-    lineOfSight.push_back(std::make_pair(newNeighbor, distance));
-}
-
 /*
  * Utility function to calculate the cross product of three points.
+ * Uses the robust orientation predicate in double precision, so the sign of the result is exact.
  *
  * @param a, b, c - The three points for which the cross product is calculated.
  *
  * @return The cross product value.
  */
-double Point::crossProduct(const Point& a, const Point& b, const Point& c) {
-    return (b.getX() - a.getX()) * (c.getY() - a.getY()) - (c.getX() - a.getX()) * (b.getY() - a.getY());
+template <typename T>
+double BasicPoint<T>::crossProduct(const BasicPoint& a, const BasicPoint& b, const BasicPoint& c) {
+    return orient2d(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY());
 }
 
 /*
@@ -59,6 +47,11 @@ double Point::crossProduct(const Point& a, const Point& b, const Point& c) {
  *
  * @return The Euclidean distance between the points.
  */
-double Point::calculateDistance(const Point& other) const {
+template <typename T>
+T BasicPoint<T>::calculateDistance(const BasicPoint& other) const {
     return sqrt(pow(other.getX() - x, 2) + pow(other.getY() - y, 2));
-}
\ No newline at end of file
+}
+
+// Instantiate the points for both supported scalar types
+template class BasicPoint<float>;
+template class BasicPoint<double>;
\ No newline at end of file
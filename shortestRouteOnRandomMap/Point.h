@@ -1,33 +1,30 @@
 #pragma once
-#include <vector>
+#include "Scalar.h"
 
-class Point {
+template <typename T>
+class BasicPoint {
 private:
-    double x, y;
-    std::vector<std::pair<Point*, double>> lineOfSight; // Store neighbors and their distances
+    T x, y;
 
 public:
     // Constructor
-    Point(double x, double y);
+    BasicPoint(T x, T y);
 
     // Getter for x-coordinate
-    double getX() const;
+    T getX() const;
 
     // Getter for y-coordinate
-    double getY() const;
-
-    // Getter for line of sight neighbors and their distances
-    const std::vector<std::pair<Point*, double>>& getlineOfSight() const;
-
-    // Set a new neighbor in the line of sight with the given distance
-    void setlineOfSight(Point* newNeighbor, double distance);
+    T getY() const;
 
     // Overload the equality (==) operator
-    bool operator==(const Point& other) const;
+    bool operator==(const BasicPoint& other) const;
 
     // Utility function to calculate the cross product of three points
-    static double crossProduct(const Point& a, const Point& b, const Point& c);
+    static double crossProduct(const BasicPoint& a, const BasicPoint& b, const BasicPoint& c);
 
     // Calculate the Euclidean distance between two points
-    double calculateDistance(const Point& other) const;
-};
\ No newline at end of file
+    T calculateDistance(const BasicPoint& other) const;
+};
+
+// A point with the scalar type of the build
+typedef BasicPoint<Scalar> Point;
\ No newline at end of file
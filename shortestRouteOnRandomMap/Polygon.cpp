@@ -1,21 +1,24 @@
 #include "Polygon.h"
+#include "GeometryStore.h"
 #include <cmath>
 
 /*
  * Constructor for the Polygon class.
  *
- * @param points - The vertices of the polygon.
- * @param number - A unique identifier for the polygon.
+ * @param store - The store holding the vertices of the polygon.
+ * @param index - The index of the polygon in the store.
  */
-Polygon::Polygon(const std::vector<Point>& points, int number) : points(points), polygonNumber(number){}
+template <typename T>
+BasicPolygon<T>::BasicPolygon(const BasicGeometryStore<T>& store, int index) : store(&store), index(index){}
 
 /*
  * Gets the unique identifier of the polygon.
  *
  * @return The unique identifier of the polygon.
  */
-int Polygon::getPolygonNumber() const {
-    return polygonNumber;
+template <typename T>
+int BasicPolygon<T>::getPolygonNumber() const {
+    return store->getPolygonNumber(index);
 }
 
 /*
@@ -23,15 +26,19 @@ int Polygon::getPolygonNumber() const {
  *
  * @return The area of the polygon.
  */
-double Polygon::calculateArea() const {
+template <typename T>
+double BasicPolygon<T>::calculateArea() const {
 
-    int n = points.size();
+    int begin = store->getPolygonBegin(index);
+    int n = getNumPoints();
+    const T* xs = store->getXs() + begin;
+    const T* ys = store->getYs() + begin;
     double area = 0.0;
 
-    // Apply the shoelace formula to calculate the area of the polygon
+    // Apply the shoelace formula to calculate the area of the polygon, in double precision
     for (int i = 0; i < n; i++) {
         int j = (i + 1) % n;
-        area += (points[i].getX() * points[j].getY() - points[j].getX() * points[i].getY());
+        area += ((double)xs[i] * ys[j] - (double)xs[j] * ys[i]);
     }
 
     // Take the absolute value and divide by 2 to get the area
@@ -39,11 +46,72 @@ double Polygon::calculateArea() const {
 }
 
 /*
- * Gets the array of points representing the vertices of the polygon.
+ * Gets the number of vertices of the polygon.
  *
- * @return A reference to the array of points.
+ * @return The number of vertices.
  */
-std::vector<Point>& Polygon::getPolygonsPointsArray()
+template <typename T>
+int BasicPolygon<T>::getNumPoints() const
 {
-    return points;
-}
\ No newline at end of file
+    return store->getPolygonEnd(index) - store->getPolygonBegin(index);
+}
+
+/*
+ * Gets a vertex of the polygon.
+ *
+ * @param point - The index of the vertex within the polygon.
+ *
+ * @return The vertex.
+ */
+template <typename T>
+BasicPoint<T> BasicPolygon<T>::getPoint(int point) const
+{
+    return store->getPoint(getVertexId(point));
+}
+
+/*
+ * Gets the vertex id of a vertex of the polygon in the store.
+ *
+ * @param point - The index of the vertex within the polygon.
+ *
+ * @return The vertex id.
+ */
+template <typename T>
+int BasicPolygon<T>::getVertexId(int point) const
+{
+    return store->getPolygonBegin(index) + point;
+}
+
+/*
+ * Checks if a point lies strictly inside the polygon.
+ * The polygon is expected to be a convex hull in counter-clockwise order,
+ * points on the boundary are not considered inside.
+ *
+ * @param point - The point to check.
+ *
+ * @return True if the point is strictly inside the polygon, false otherwise.
+ */
+template <typename T>
+bool BasicPolygon<T>::containsPoint(const BasicPoint<T>& point) const
+{
+    int n = getNumPoints();
+    if (n < 3)
+    {
+        return false;
+    }
+
+    // The point must be strictly on the left side of every edge
+    for (int i = 0; i < n; i++)
+    {
+        if (BasicPoint<T>::crossProduct(getPoint(i), getPoint((i + 1) % n), point) <= 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Instantiate the polygons for both supported scalar types
+template class BasicPolygon<float>;
+template class BasicPolygon<double>;
@@ -1,17 +1,21 @@
 #pragma once
 #include "Point.h"
-#include <vector>
 
-class Polygon {
+template <typename T>
+class BasicGeometryStore;
+
+// A view of a polygon whose vertices live in a GeometryStore
+template <typename T>
+class BasicPolygon {
 private:
-	// The vertices of the polygon
-	std::vector<Point> points;
-	// A unique identifier for the polygon
-	int polygonNumber;
+	// The store holding the vertices of the polygon
+	const BasicGeometryStore<T>* store;
+	// The index of the polygon in the store
+	int index;
 
 public:
 	// Constructor for the Polygon class.
-	Polygon(const std::vector<Point>& points, int number);
+	BasicPolygon(const BasicGeometryStore<T>& store, int index);
 
 	// Gets the unique identifier of the polygon.
 	int getPolygonNumber() const;
@@ -19,6 +23,18 @@ public:
 	// Calculates the area of the polygon.
 	double calculateArea() const;
 
-	// Gets the array of points representing the vertices of the polygon.
-	std::vector<Point>& getPolygonsPointsArray();
+	// Gets the number of vertices of the polygon.
+	int getNumPoints() const;
+
+	// Gets a vertex of the polygon.
+	BasicPoint<T> getPoint(int point) const;
+
+	// Gets the vertex id of a vertex of the polygon in the store.
+	int getVertexId(int point) const;
+
+	// Checks if a point lies strictly inside the (convex) polygon.
+	bool containsPoint(const BasicPoint<T>& point) const;
 };
+
+// A polygon with the scalar type of the build
+typedef BasicPolygon<Scalar> Polygon;
@@ -0,0 +1,146 @@
+#include "PolygonIndex.h"
+#include <algorithm>
+#include <limits>
+
+// An empty box, that any extended point replaces
+BoundingBox BoundingBox::empty()
+{
+    double infinity = std::numeric_limits<double>::infinity();
+    return { infinity, infinity, -infinity, -infinity };
+}
+
+/*
+ * Grow the box to contain a point.
+ *
+ * @param x, y - The coordinates of the point.
+ */
+void BoundingBox::extend(double x, double y)
+{
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+}
+
+/*
+ * Check if two boxes overlap. Boxes that only touch overlap too.
+ *
+ * @param other - The other box.
+ *
+ * @return True if the boxes share at least one point, false otherwise.
+ */
+bool BoundingBox::overlaps(const BoundingBox& other) const
+{
+    return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+}
+
+/*
+ * Calculate the bounding box of a polygon.
+ *
+ * @param store - The store holding the polygon.
+ * @param polygon - The index of the polygon.
+ *
+ * @return The bounding box of the polygon.
+ */
+BoundingBox calculateBoundingBox(const GeometryStore& store, int polygon)
+{
+    BoundingBox box = BoundingBox::empty();
+
+    for (int vertex = store.getPolygonBegin(polygon); vertex < store.getPolygonEnd(polygon); vertex++)
+    {
+        box.extend(store.getX(vertex), store.getY(vertex));
+    }
+
+    return box;
+}
+
+// Remove all polygons
+void PolygonIndex::clear()
+{
+    boxes.clear();
+}
+
+/*
+ * Index all the polygons of a store.
+ *
+ * @param store - The store holding the polygons.
+ */
+void PolygonIndex::build(const GeometryStore& store)
+{
+    boxes.clear();
+    boxes.reserve(store.getNumPolygons());
+    for (int polygon = 0; polygon < store.getNumPolygons(); polygon++)
+    {
+        boxes.push_back(calculateBoundingBox(store, polygon));
+    }
+}
+
+/*
+ * Add the next polygon. Polygons must be inserted in the order of the store.
+ *
+ * @param box - The bounding box of the polygon.
+ */
+void PolygonIndex::insert(const BoundingBox& box)
+{
+    boxes.push_back(box);
+}
+
+// Getter implementation for the number of indexed polygons
+int PolygonIndex::getNumPolygons() const
+{
+    return boxes.size();
+}
+
+// Getter implementation for the bounding box of a polygon
+const BoundingBox& PolygonIndex::getBox(int polygon) const
+{
+    return boxes[polygon];
+}
+
+/*
+ * Check if a segment may touch a polygon, by comparing their bounding boxes.
+ *
+ * @param polygon - The index of the polygon.
+ * @param from, to - The endpoints of the segment.
+ *
+ * @return False if the segment certainly does not touch the polygon, true otherwise.
+ */
+bool PolygonIndex::mayTouch(int polygon, const Point& from, const Point& to) const
+{
+    const BoundingBox& box = boxes[polygon];
+    return std::min(from.getX(), to.getX()) <= box.maxX && box.minX <= std::max(from.getX(), to.getX()) &&
+        std::min(from.getY(), to.getY()) <= box.maxY && box.minY <= std::max(from.getY(), to.getY());
+}
+
+/*
+ * Find every pair of polygons whose bounding boxes overlap. The boxes are sorted by
+ * their left side and swept from left to right, so each box is only compared with the
+ * boxes starting before its right side: O(P log P + k) for P polygons and k pairs whose
+ * x ranges overlap, instead of comparing all P * P pairs.
+ *
+ * @return The overlapping pairs, each once with the lower polygon index first.
+ */
+std::vector<std::pair<int, int>> PolygonIndex::findOverlappingPairs() const
+{
+    std::vector<int> order(boxes.size());
+    for (size_t polygon = 0; polygon < boxes.size(); polygon++)
+    {
+        order[polygon] = polygon;
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return boxes[a].minX < boxes[b].minX; });
+
+    std::vector<std::pair<int, int>> pairs;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const BoundingBox& box = boxes[order[i]];
+        for (size_t j = i + 1; j < order.size() && boxes[order[j]].minX <= box.maxX; j++)
+        {
+            if (box.overlaps(boxes[order[j]]))
+            {
+                pairs.push_back({ std::min(order[i], order[j]), std::max(order[i], order[j]) });
+            }
+        }
+    }
+
+    return pairs;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Point.h"
+#include "GeometryStore.h"
+#include <utility>
+#include <vector>
+
+/*
+ * Axis-aligned bounding box, used to skip polygons that cannot interact.
+ */
+struct BoundingBox
+{
+    double minX, minY, maxX, maxY;
+
+    // An empty box, that any extended point replaces
+    static BoundingBox empty();
+
+    // Grow the box to contain a point
+    void extend(double x, double y);
+
+    // Check if two boxes overlap or touch
+    bool overlaps(const BoundingBox& other) const;
+};
+
+// Calculate the bounding box of a polygon in a store
+BoundingBox calculateBoundingBox(const GeometryStore& store, int polygon);
+
+/*
+ * Spatial index of the convex hulls: the bounding box of every polygon, indexed like
+ * the polygons of the store. Segment tests check a hull's edges only when the
+ * segment's bounding box overlaps the hull's.
+ */
+class PolygonIndex {
+private:
+    // Bounding box of each polygon
+    std::vector<BoundingBox> boxes;
+
+public:
+    // Remove all polygons
+    void clear();
+
+    // Index all the polygons of a store
+    void build(const GeometryStore& store);
+
+    // Add the next polygon
+    void insert(const BoundingBox& box);
+
+    // Get the number of indexed polygons
+    int getNumPolygons() const;
+
+    // Get the bounding box of a polygon
+    const BoundingBox& getBox(int polygon) const;
+
+    // Check if a segment may touch a polygon
+    bool mayTouch(int polygon, const Point& from, const Point& to) const;
+
+    // Find every pair of polygons whose bounding boxes overlap, the lower index first
+    std::vector<std::pair<int, int>> findOverlappingPairs() const;
+};
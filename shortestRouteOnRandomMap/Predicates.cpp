@@ -0,0 +1,338 @@
+#include "Predicates.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Half an ulp of 1.0, the relative rounding error of one operation
+const double epsilon = std::ldexp(1.0, -53);
+
+// Bound on the relative error of the filtered orientation determinant
+const double orientErrorBound = (3.0 + 16.0 * epsilon) * epsilon;
+
+// Bound on the relative error of the filtered incircle determinant
+const double incircleErrorBound = (10.0 + 96.0 * epsilon) * epsilon;
+
+/*
+ * Exact sum of two doubles: a + b == x + y, where x is the rounded sum.
+ */
+inline void twoSum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bVirtual = x - a;
+    double aVirtual = x - bVirtual;
+    y = (a - aVirtual) + (b - bVirtual);
+}
+
+/*
+ * Exact difference of two doubles: a - b == x + y, where x is the rounded difference.
+ */
+inline void twoDiff(double a, double b, double& x, double& y)
+{
+    x = a - b;
+    double bVirtual = a - x;
+    double aVirtual = x + bVirtual;
+    y = (a - aVirtual) + (bVirtual - b);
+}
+
+/*
+ * Exact product of two doubles: a * b == x + y, where x is the rounded product.
+ */
+inline void twoProduct(double a, double b, double& x, double& y)
+{
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+/*
+ * Add a double to an expansion (a sum of non-overlapping doubles of increasing magnitude).
+ * The result is again such an expansion, with zero components removed.
+ *
+ * @param expansion - The components of the expansion, updated in place.
+ * @param length - The number of components.
+ * @param value - The double to add.
+ *
+ * @return The number of components of the result.
+ */
+int growExpansion(double* expansion, int length, double value)
+{
+    double sum = value;
+    int resultLength = 0;
+
+    for (int i = 0; i < length; i++)
+    {
+        double error;
+        twoSum(sum, expansion[i], sum, error);
+        if (error != 0.0)
+        {
+            expansion[resultLength++] = error;
+        }
+    }
+
+    if (sum != 0.0 || resultLength == 0)
+    {
+        expansion[resultLength++] = sum;
+    }
+
+    return resultLength;
+}
+
+/*
+ * Sum a list of doubles exactly.
+ *
+ * @param terms - The doubles to sum, overwritten with the resulting expansion.
+ * @param count - The number of doubles.
+ *
+ * @return The most significant component of the exact sum, which has its sign.
+ */
+double exactSum(double* terms, int count)
+{
+    int length = 0;
+    for (int i = 0; i < count; i++)
+    {
+        double term = terms[i];
+        length = growExpansion(terms, length, term);
+    }
+    return terms[length - 1];
+}
+
+/*
+ * Exact orientation determinant, used when the filter is inconclusive.
+ * First tries the cheap case where the coordinate differences are exact,
+ * otherwise expands the determinant into six exact products.
+ */
+double orient2dExact(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    double acx, acxTail, bcx, bcxTail, acy, acyTail, bcy, bcyTail;
+    twoDiff(ax, cx, acx, acxTail);
+    twoDiff(bx, cx, bcx, bcxTail);
+    twoDiff(ay, cy, acy, acyTail);
+    twoDiff(by, cy, bcy, bcyTail);
+
+    double terms[12];
+
+    if (acxTail == 0.0 && bcxTail == 0.0 && acyTail == 0.0 && bcyTail == 0.0)
+    {
+        // acx * bcy - acy * bcx with exact products
+        twoProduct(acx, bcy, terms[0], terms[1]);
+        twoProduct(-acy, bcx, terms[2], terms[3]);
+        return exactSum(terms, 4);
+    }
+
+    // ax*by - ax*cy - ay*bx + ay*cx + bx*cy - by*cx with exact products
+    twoProduct(ax, by, terms[0], terms[1]);
+    twoProduct(-ax, cy, terms[2], terms[3]);
+    twoProduct(-ay, bx, terms[4], terms[5]);
+    twoProduct(ay, cx, terms[6], terms[7]);
+    twoProduct(bx, cy, terms[8], terms[9]);
+    twoProduct(-by, cx, terms[10], terms[11]);
+    return exactSum(terms, 12);
+}
+
+/*
+ * Arbitrary length expansion, used by the exact incircle fallback.
+ */
+typedef std::vector<double> Expansion;
+
+/*
+ * Add a double to an expansion.
+ *
+ * @param expansion - The expansion, updated in place.
+ * @param value - The double to add.
+ */
+void grow(Expansion& expansion, double value)
+{
+    int length = expansion.size();
+    expansion.push_back(0.0);
+    expansion.resize(growExpansion(expansion.data(), length, value));
+}
+
+/*
+ * Exact difference of two doubles as an expansion.
+ */
+Expansion difference(double a, double b)
+{
+    double x, y;
+    twoDiff(a, b, x, y);
+    Expansion result;
+    grow(result, y);
+    grow(result, x);
+    return result;
+}
+
+/*
+ * Exact sum of two expansions.
+ */
+Expansion add(const Expansion& e, const Expansion& f)
+{
+    Expansion result = e;
+    for (double component : f)
+    {
+        grow(result, component);
+    }
+    return result;
+}
+
+/*
+ * Exact product of two expansions, negated if requested.
+ */
+Expansion multiply(const Expansion& e, const Expansion& f, bool negate = false)
+{
+    Expansion result;
+    for (double a : e)
+    {
+        for (double b : f)
+        {
+            double x, y;
+            twoProduct(negate ? -a : a, b, x, y);
+            grow(result, y);
+            grow(result, x);
+        }
+    }
+    return result;
+}
+
+/*
+ * Exact incircle determinant, used when the filter is inconclusive.
+ */
+double incircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+{
+    Expansion adx = difference(ax, dx), ady = difference(ay, dy);
+    Expansion bdx = difference(bx, dx), bdy = difference(by, dy);
+    Expansion cdx = difference(cx, dx), cdy = difference(cy, dy);
+
+    Expansion alift = add(multiply(adx, adx), multiply(ady, ady));
+    Expansion blift = add(multiply(bdx, bdx), multiply(bdy, bdy));
+    Expansion clift = add(multiply(cdx, cdx), multiply(cdy, cdy));
+
+    Expansion bc = add(multiply(bdx, cdy), multiply(bdy, cdx, true));
+    Expansion ca = add(multiply(cdx, ady), multiply(cdy, adx, true));
+    Expansion ab = add(multiply(adx, bdy), multiply(ady, bdx, true));
+
+    Expansion det = add(add(multiply(alift, bc), multiply(blift, ca)), multiply(clift, ab));
+    return det.back();
+}
+
+}
+
+/*
+ * Orientation of three points, with an exact sign.
+ *
+ * @param ax, ay, bx, by, cx, cy - The coordinates of the three points.
+ *
+ * @return A value that is positive if the points turn counter-clockwise, negative if
+ *         they turn clockwise and zero if they are collinear. Its magnitude approximates
+ *         twice the area of the triangle.
+ */
+double orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    double detLeft = (ax - cx) * (by - cy);
+    double detRight = (ay - cy) * (bx - cx);
+    double det = detLeft - detRight;
+
+    // The filter: the rounded determinant has the right sign if it is large enough
+    double detSum = std::abs(detLeft) + std::abs(detRight);
+    if (std::abs(det) >= orientErrorBound * detSum)
+    {
+        return det;
+    }
+
+    return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+/*
+ * Orientation of three points, with an exact sign.
+ *
+ * @param a, b, c - The three points.
+ *
+ * @return A value whose sign is the orientation of the points.
+ */
+double orient2d(const Point& a, const Point& b, const Point& c)
+{
+    return orient2d(a.getX(), a.getY(), b.getX(), b.getY(), c.getX(), c.getY());
+}
+
+/*
+ * Sign of the orientation of three points.
+ *
+ * @param a, b, c - The three points.
+ *
+ * @return 1 if the points turn counter-clockwise, -1 if clockwise and 0 if collinear.
+ */
+int orientation(const Point& a, const Point& b, const Point& c)
+{
+    double det = orient2d(a, b, c);
+    return (det > 0) - (det < 0);
+}
+
+/*
+ * Check if two line segments defined by points (p1, p2) and (p3, p4) are crossing.
+ * Segments that only touch count as crossing, collinear segments never cross.
+ *
+ * @param p1, p2 - Points defining the first line segment.
+ * @param p3, p4 - Points defining the second line segment.
+ *
+ * @return True if the line segments intersect, false otherwise.
+ */
+bool areLinesCrossing(const Point& p1, const Point& p2, const Point& p3, const Point& p4)
+{
+    // Segments with disjoint bounding boxes cannot intersect
+    if (std::max(p1.getX(), p2.getX()) < std::min(p3.getX(), p4.getX()) ||
+        std::max(p3.getX(), p4.getX()) < std::min(p1.getX(), p2.getX()) ||
+        std::max(p1.getY(), p2.getY()) < std::min(p3.getY(), p4.getY()) ||
+        std::max(p3.getY(), p4.getY()) < std::min(p1.getY(), p2.getY()))
+    {
+        return false;
+    }
+
+    // The second segment must touch or straddle the line through the first one
+    int o1 = orientation(p1, p2, p3);
+    int o2 = orientation(p1, p2, p4);
+    if (o1 * o2 > 0 || (o1 == 0 && o2 == 0))
+    {
+        return false;
+    }
+
+    // And the first segment must touch or straddle the line through the second one
+    int o3 = orientation(p3, p4, p1);
+    int o4 = orientation(p3, p4, p2);
+    return o3 * o4 <= 0;
+}
+
+/*
+ * Position of a point relative to the circle through three points, with an exact sign.
+ *
+ * @param ax, ay, bx, by, cx, cy - Three points in counter-clockwise order.
+ * @param dx, dy - The point to test.
+ *
+ * @return A value that is positive if d lies inside the circle, negative if it lies
+ *         outside and zero if the four points are cocircular.
+ */
+double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+{
+    double adx = ax - dx, ady = ay - dy;
+    double bdx = bx - dx, bdy = by - dy;
+    double cdx = cx - dx, cdy = cy - dy;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+    // The filter: the rounded determinant has the right sign if it is large enough
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+        + (std::abs(cdxady) + std::abs(adxcdy)) * blift
+        + (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    if (std::abs(det) > incircleErrorBound * permanent)
+    {
+        return det;
+    }
+
+    return incircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "Point.h"
+
+/*
+ * Robust geometric predicates.
+ *
+ * The orientation and incircle tests are evaluated with a fast floating point filter. Only when the
+ * filter cannot certify the sign, it falls back to exact expansion arithmetic, so the
+ * sign is always correct. No predicate divides, so vertical and near parallel segments
+ * are handled like any other. Must not be compiled with unsafe floating point
+ * optimizations (e.g. -ffast-math), which break the exact arithmetic.
+ */
+
+// Orientation of three points: positive if a, b, c turn counter-clockwise, negative if clockwise and zero if collinear
+double orient2d(double ax, double ay, double bx, double by, double cx, double cy);
+double orient2d(const Point& a, const Point& b, const Point& c);
+
+// Sign (-1, 0 or 1) of the orientation of three points
+int orientation(const Point& a, const Point& b, const Point& c);
+
+// Position of d relative to the circle through a, b, c (counter-clockwise): positive if inside, negative if outside and zero if on it
+double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+// Check if two line segments touch or cross each other, collinear segments never cross
+bool areLinesCrossing(const Point& p1, const Point& p2, const Point& p3, const Point& p4);
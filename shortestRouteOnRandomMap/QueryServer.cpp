@@ -0,0 +1,386 @@
+#include "QueryServer.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// How often the map file is checked for changes
+const std::chrono::milliseconds pollInterval(500);
+
+// Size of a request: four doubles
+const size_t requestSize = 4 * sizeof(double);
+
+#ifndef _WIN32
+
+// Set by the signal handler to stop the server
+volatile std::sig_atomic_t stopSignal = 0;
+
+// Signal handler for SIGINT and SIGTERM
+void requestStop(int)
+{
+    stopSignal = 1;
+}
+
+/*
+ * Read exactly a number of bytes from a socket.
+ *
+ * @return True if all the bytes were read, false if the connection closed first.
+ */
+bool readFully(int socket, char* buffer, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t count = read(socket, buffer, size);
+        if (count <= 0)
+        {
+            return false;
+        }
+        buffer += count;
+        size -= count;
+    }
+    return true;
+}
+
+/*
+ * Write exactly a number of bytes to a socket.
+ *
+ * @return True if all the bytes were written, false if the connection closed first.
+ */
+bool writeFully(int socket, const char* buffer, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t count = write(socket, buffer, size);
+        if (count <= 0)
+        {
+            return false;
+        }
+        buffer += count;
+        size -= count;
+    }
+    return true;
+}
+
+#endif
+
+// Append the bytes of a value to a buffer
+template <typename Value>
+void append(std::vector<char>& buffer, Value value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(Value));
+}
+
+}
+
+// Constructor
+QueryServer::QueryServer(const std::string& mapFile, const std::string& socketPath, bool reorder, bool useMatrix)
+    : mapFile(mapFile), socketPath(socketPath), reorder(reorder), useMatrix(useMatrix), stopping(false), idleWorkers(0) {
+}
+
+/*
+ * Read the map file and build its line of sight graph, the same way as a single run
+ * of the visibility engine.
+ *
+ * @return The built graph, null if the map file cannot be opened or is malformed.
+ */
+std::shared_ptr<const ControlManager> QueryServer::buildGraph() const
+{
+    std::shared_ptr<ControlManager> manager = std::make_shared<ControlManager>();
+    manager->setVisibilityMatrix(useMatrix);
+    if (!manager->readData(mapFile))
+    {
+        return nullptr;
+    }
+    manager->performConvexHull();
+    manager->pruneHiddenPoints();
+    if (reorder)
+    {
+        manager->reorderAlongHilbertCurve();
+    }
+    manager->findPointslineOfSight();
+    return manager;
+}
+
+/*
+ * Wait until the server stops or the timeout passes.
+ *
+ * @param timeout - The longest time to wait.
+ *
+ * @return True if the server is stopping, false if the timeout passed first.
+ */
+bool QueryServer::waitForStop(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    return stopped.wait_for(lock, timeout, [this] { return stopping; });
+}
+
+/*
+ * Poll the modification time of the map file and rebuild the graph when it changes.
+ * The new graph is built on this thread and published with one atomic store, so
+ * queries never wait for a rebuild. If the new file cannot be read, for example while
+ * it is still being written, the previous graph keeps serving until the next change.
+ */
+void QueryServer::watchMapFile()
+{
+    std::error_code error;
+    auto lastWrite = std::filesystem::last_write_time(mapFile, error);
+
+    while (!waitForStop(pollInterval))
+    {
+        auto writeTime = std::filesystem::last_write_time(mapFile, error);
+        if (error || writeTime == lastWrite)
+        {
+            continue;
+        }
+        lastWrite = writeTime;
+
+        std::shared_ptr<const ControlManager> graph = buildGraph();
+        if (graph)
+        {
+            std::atomic_store(&current, graph);
+            std::cout << "Map reloaded." << std::endl;
+        }
+        else
+        {
+            std::cerr << "Map reload failed, keeping the previous map." << std::endl;
+        }
+    }
+}
+
+/*
+ * Serve the clients taken from the queue, one at a time. The socket being served is
+ * recorded, so a stopping server can disconnect it; a client taken after the server
+ * started stopping is closed at once.
+ *
+ * @param clients - The queue of accepted sockets, closed when the server stops.
+ * @param worker - The index of this worker.
+ */
+void QueryServer::serveClients(BoundedQueue<int>& clients, int worker)
+{
+#ifndef _WIN32
+    int client;
+    while (clients.pop(client))
+    {
+        bool serve;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            serve = !stopping;
+            activeClients[worker] = serve ? client : -1;
+        }
+
+        if (serve)
+        {
+            serveClient(client);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            activeClients[worker] = -1;
+            close(client);
+            idleWorkers++;
+        }
+        workerIdle.notify_one();
+    }
+#else
+    (void)clients;
+    (void)worker;
+#endif
+}
+
+/*
+ * Answer the requests of one client. Each request takes the current graph once, so a
+ * graph swapped in meanwhile is used from the next request on.
+ *
+ * @param client - The connected socket, left open for the caller to close.
+ */
+void QueryServer::serveClient(int client)
+{
+#ifndef _WIN32
+    char request[requestSize];
+    std::vector<char> response;
+    std::vector<Point> route;
+
+    while (readFully(client, request, requestSize))
+    {
+        double values[4];
+        std::memcpy(values, request, requestSize);
+        Point from(values[0], values[1]);
+        Point to(values[2], values[3]);
+
+        std::shared_ptr<const ControlManager> graph = std::atomic_load(&current);
+
+        QueryStatus status = QueryStatus::NotFound;
+        route.clear();
+        if (graph->isInsideObstacle(from) || graph->isInsideObstacle(to))
+        {
+            status = QueryStatus::InsideObstacle;
+        }
+        else if (graph->findRoute(from, to, route))
+        {
+            status = QueryStatus::Found;
+        }
+
+        double length = 0;
+        for (size_t i = 1; i < route.size(); i++)
+        {
+            length += route[i - 1].calculateDistance(route[i]);
+        }
+
+        response.clear();
+        append(response, (uint32_t)status);
+        append(response, (uint32_t)route.size());
+        append(response, length);
+        for (const Point& point : route)
+        {
+            append(response, (double)point.getX());
+            append(response, (double)point.getY());
+        }
+
+        if (!writeFully(client, response.data(), response.size()))
+        {
+            break;
+        }
+    }
+#else
+    (void)client;
+#endif
+}
+
+/*
+ * Build the graph of the map, then listen on the socket and hand the clients to a pool
+ * of workers while another thread watches the map file. A client is only accepted when
+ * a worker is free. On SIGINT or SIGTERM the clients are disconnected, all the threads
+ * are joined and the socket is removed.
+ *
+ * @return An error code if the map or the socket cannot be set up, 0 once the server stopped.
+ */
+int QueryServer::run()
+{
+#ifndef _WIN32
+    current = buildGraph();
+    if (!current)
+    {
+        return 1;
+    }
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path is too long: " << socketPath << std::endl;
+        return 1;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    // Replace the socket left by a previous server, but never another kind of file
+    struct stat status;
+    if (lstat(socketPath.c_str(), &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+        {
+            std::cerr << "Refusing to replace " << socketPath << ": it is not a socket." << std::endl;
+            return 1;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 16) < 0)
+    {
+        std::cerr << "Unable to listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // A client that disconnects early must not stop the server
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    BoundedQueue<int> clients(MAX_CLIENTS);
+    activeClients.assign(MAX_CLIENTS, -1);
+    idleWorkers = MAX_CLIENTS;
+
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < MAX_CLIENTS; worker++)
+    {
+        workers.emplace_back(&QueryServer::serveClients, this, std::ref(clients), worker);
+    }
+    std::thread watcher(&QueryServer::watchMapFile, this);
+    std::cout << "Listening on " << socketPath << std::endl;
+
+    // Waits are bounded by the poll interval so a stop signal is noticed
+    pollfd listening = { listener, POLLIN, 0 };
+    while (!stopSignal)
+    {
+        {
+            // Leave new clients in the listen backlog while every worker is busy
+            std::unique_lock<std::mutex> lock(stateMutex);
+            if (!workerIdle.wait_for(lock, pollInterval, [this] { return idleWorkers > 0; }))
+            {
+                continue;
+            }
+        }
+
+        if (poll(&listening, 1, (int)pollInterval.count()) <= 0)
+        {
+            continue;
+        }
+
+        int client = accept(listener, nullptr, nullptr);
+        if (client >= 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                idleWorkers--;
+            }
+            clients.push(client);
+        }
+    }
+
+    // Stop the watcher and disconnect the clients being served, so every thread can be joined
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+        for (int client : activeClients)
+        {
+            if (client >= 0)
+            {
+                shutdown(client, SHUT_RDWR);
+            }
+        }
+    }
+    stopped.notify_all();
+    clients.close();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    watcher.join();
+
+    close(listener);
+    unlink(socketPath.c_str());
+    std::cout << "Stopped." << std::endl;
+    return 0;
+#else
+    std::cerr << "Daemon mode requires Unix domain sockets." << std::endl;
+    return 1;
+#endif
+}
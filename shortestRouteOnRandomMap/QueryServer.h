@@ -0,0 +1,83 @@
+#pragma once
+#include "ControlManager.h"
+#include "BoundedQueue.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Result of a route query
+enum class QueryStatus : uint32_t {
+    Found = 0,
+    NotFound = 1,
+    InsideObstacle = 2
+};
+
+/*
+ * Long-running route server for one map over a Unix domain socket.
+ *
+ * The map is read and its line of sight graph built once, then every query reuses it.
+ * The map file is polled for changes: a new graph is built in the background and
+ * swapped in as a whole, while the queries already running finish on the graph they
+ * started with.
+ *
+ * A fixed pool of workers serves the clients, one client per worker. While every worker
+ * is busy, new connections wait in the listen backlog. SIGINT or SIGTERM stops the server:
+ * the connected clients are disconnected and every thread is joined before run() returns.
+ *
+ * Protocol, all values in host byte order. A client sends any number of requests on
+ * one connection and reads one response after each:
+ *   request:  4 doubles - start x, start y, goal x, goal y
+ *   response: uint32 status (a QueryStatus), uint32 number of points n, double route
+ *             length, then n pairs of doubles - the points of the route
+ */
+class QueryServer {
+private:
+    std::string mapFile, socketPath;
+    bool reorder, useMatrix;
+
+    // Graph of the current map, read and replaced with the atomic shared_ptr functions
+    std::shared_ptr<const ControlManager> current;
+
+    // Guards the fields below
+    std::mutex stateMutex;
+
+    // Set once the server stops, signalled to the map watcher
+    bool stopping;
+    std::condition_variable stopped;
+
+    // Number of workers waiting for a client, signalled when a worker becomes free
+    int idleWorkers;
+    std::condition_variable workerIdle;
+
+    // Socket served by each worker, -1 while it waits for a client
+    std::vector<int> activeClients;
+
+    // Read a map file and build its line of sight graph
+    std::shared_ptr<const ControlManager> buildGraph() const;
+
+    // Wait until the server stops or the timeout passes, true if it stopped
+    bool waitForStop(std::chrono::milliseconds timeout);
+
+    // Rebuild the graph whenever the map file changes, until the server stops
+    void watchMapFile();
+
+    // Serve the clients taken from the queue, one at a time, until the queue is closed
+    void serveClients(BoundedQueue<int>& clients, int worker);
+
+    // Answer the requests of one client until it disconnects
+    void serveClient(int client);
+
+public:
+    // Largest number of clients served at the same time
+    static const int MAX_CLIENTS = 16;
+
+    // Constructor
+    QueryServer(const std::string& mapFile, const std::string& socketPath, bool reorder, bool useMatrix);
+
+    // Build the graph and serve queries until SIGINT or SIGTERM, returns an error code if the socket cannot be set up
+    int run();
+};
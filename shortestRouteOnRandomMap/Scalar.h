@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+ * Scalar type of the coordinates and edge weights.
+ *
+ * The geometry and graph classes are templates over the scalar type, and the program
+ * uses them with the type selected here. Build with -DSHORTEST_ROUTE_FLOAT32 for single
+ * precision, which halves the memory of the coordinates and the edge weights. The
+ * geometric predicates evaluate in double precision with an exact fallback, so their
+ * signs stay exact either way: every float is exactly representable as a double.
+ */
+#ifdef SHORTEST_ROUTE_FLOAT32
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
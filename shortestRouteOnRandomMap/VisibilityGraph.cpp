@@ -0,0 +1,122 @@
+#include "VisibilityGraph.h"
+
+/*
+ * Remove all edges and set the number of vertices.
+ *
+ * @param numVertices - The number of vertices in the graph.
+ */
+template <typename T>
+void BasicVisibilityGraph<T>::reset(int numVertices)
+{
+    pendingEdges.clear();
+    offsets.assign(numVertices + 1, 0);
+    targets.clear();
+    distances.clear();
+}
+
+/*
+ * Add an edge from one vertex to another. The edge is available after build().
+ *
+ * @param from - The vertex id the edge starts at.
+ * @param to - The vertex id the edge ends at.
+ * @param distance - The length of the edge.
+ */
+template <typename T>
+void BasicVisibilityGraph<T>::addEdge(int from, int to, T distance)
+{
+    pendingEdges.push_back({ from, to, distance });
+}
+
+/*
+ * Pack the collected edges into the adjacency arrays with a counting sort on the
+ * start vertex, which keeps the order in which the edges of each vertex were added.
+ */
+template <typename T>
+void BasicVisibilityGraph<T>::build()
+{
+    int numVertices = getNumVertices();
+
+    // Count the edges of each vertex
+    std::vector<int> counts(numVertices + 1, 0);
+    for (const Edge& edge : pendingEdges)
+    {
+        counts[edge.from + 1]++;
+    }
+
+    // Turn the counts into offsets
+    for (int vertex = 0; vertex < numVertices; vertex++)
+    {
+        counts[vertex + 1] += counts[vertex];
+    }
+    offsets = counts;
+
+    // Place each edge in the range of its start vertex
+    targets.resize(pendingEdges.size());
+    distances.resize(pendingEdges.size());
+    for (const Edge& edge : pendingEdges)
+    {
+        int position = counts[edge.from]++;
+        targets[position] = edge.to;
+        distances[position] = edge.distance;
+    }
+
+    pendingEdges.clear();
+    pendingEdges.shrink_to_fit();
+}
+
+// Getter implementation for the number of vertices
+template <typename T>
+int BasicVisibilityGraph<T>::getNumVertices() const
+{
+    return offsets.size() - 1;
+}
+
+// Getter implementation for the number of edges
+template <typename T>
+int BasicVisibilityGraph<T>::getNumEdges() const
+{
+    return targets.size();
+}
+
+// Getter implementations for the range of neighbors of a vertex
+template <typename T>
+int BasicVisibilityGraph<T>::getNeighborsBegin(int vertex) const
+{
+    return offsets[vertex];
+}
+
+template <typename T>
+int BasicVisibilityGraph<T>::getNeighborsEnd(int vertex) const
+{
+    return offsets[vertex + 1];
+}
+
+// Getter implementation for the neighbor of an edge
+template <typename T>
+int BasicVisibilityGraph<T>::getTarget(int edge) const
+{
+    return targets[edge];
+}
+
+// Getter implementation for the distance of an edge
+template <typename T>
+T BasicVisibilityGraph<T>::getDistance(int edge) const
+{
+    return distances[edge];
+}
+
+/*
+ * Get the number of bytes used by the adjacency arrays after build().
+ *
+ * @return The size of the offsets, targets and distances in bytes.
+ */
+template <typename T>
+size_t BasicVisibilityGraph<T>::getMemoryUsage() const
+{
+    return (offsets.capacity() + targets.capacity()) * sizeof(int) + distances.capacity() * sizeof(T) +
+        pendingEdges.capacity() * sizeof(Edge);
+}
+
+// Instantiate the graphs for both supported scalar types
+template class BasicVisibilityGraph<float>;
+template class BasicVisibilityGraph<double>;
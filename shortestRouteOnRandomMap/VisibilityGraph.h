@@ -0,0 +1,72 @@
+#pragma once
+#include "Scalar.h"
+#include <vector>
+#include <cstddef>
+
+/*
+ * Line of sight graph over the vertex ids of a GeometryStore.
+ *
+ * Edges are collected with addEdge() and then packed by build() into one compressed
+ * adjacency array, so the neighbors of a vertex are contiguous in memory. The neighbors
+ * of each vertex keep the order in which their edges were added.
+ */
+template <typename T>
+class BasicVisibilityGraph {
+private:
+    // Edges collected before build()
+    struct Edge
+    {
+        int from, to;
+        T distance;
+    };
+    std::vector<Edge> pendingEdges;
+
+    // Index of the first neighbor of each vertex, with a final entry past the last neighbor
+    std::vector<int> offsets;
+
+    // Neighbor vertex ids and their distances
+    std::vector<int> targets;
+    std::vector<T> distances;
+
+public:
+    // Remove all edges and set the number of vertices
+    void reset(int numVertices);
+
+    // Add an edge from one vertex to another with the given distance
+    void addEdge(int from, int to, T distance);
+
+    // Pack the collected edges into the adjacency arrays
+    void build();
+
+    // Get the number of vertices
+    int getNumVertices() const;
+
+    // Get the number of edges
+    int getNumEdges() const;
+
+    // Get the range of edge indices of the neighbors of a vertex
+    int getNeighborsBegin(int vertex) const;
+    int getNeighborsEnd(int vertex) const;
+
+    // Get the neighbor vertex id of an edge
+    int getTarget(int edge) const;
+
+    // Get the distance of an edge
+    T getDistance(int edge) const;
+
+    // Get the number of bytes used by the adjacency arrays
+    size_t getMemoryUsage() const;
+
+    // Call visit(neighbor, distance) for every neighbor of a vertex
+    template <typename Visitor>
+    void forEachNeighbor(int vertex, Visitor visit) const
+    {
+        for (int edge = offsets[vertex]; edge < offsets[vertex + 1]; edge++)
+        {
+            visit(targets[edge], distances[edge]);
+        }
+    }
+};
+
+// A visibility graph with the scalar type of the build
+typedef BasicVisibilityGraph<Scalar> VisibilityGraph;
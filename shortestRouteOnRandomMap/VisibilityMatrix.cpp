@@ -0,0 +1,107 @@
+#include "VisibilityMatrix.h"
+#include <algorithm>
+
+// Constructor
+template <typename T>
+BasicVisibilityMatrix<T>::BasicVisibilityMatrix() : store(nullptr) {}
+
+/*
+ * Lay out the slots for the vertices of a store and clear all the pairs: the start
+ * point, the polygons in store order, then the end point. Each row starts on a word
+ * boundary, so the neighbors after a slot can be scanned a word at a time.
+ *
+ * @param newStore - The store holding the vertices, must outlive the matrix.
+ */
+template <typename T>
+void BasicVisibilityMatrix<T>::reset(const BasicGeometryStore<T>& newStore)
+{
+    store = &newStore;
+    int numVertices = store->getNumVertices();
+
+    slotVertices.assign(numVertices, -1);
+    vertexSlots.assign(numVertices, -1);
+    vertexPolygons.assign(numVertices, -1);
+
+    int numSlots = 0;
+    slotVertices[numSlots++] = BasicGeometryStore<T>::START_VERTEX;
+    for (int polygon = 0; polygon < store->getNumPolygons(); polygon++)
+    {
+        for (int vertex = store->getPolygonBegin(polygon); vertex < store->getPolygonEnd(polygon); vertex++)
+        {
+            slotVertices[numSlots++] = vertex;
+            vertexPolygons[vertex] = polygon;
+        }
+    }
+    slotVertices[numSlots++] = BasicGeometryStore<T>::END_VERTEX;
+
+    for (int slot = 0; slot < numSlots; slot++)
+    {
+        vertexSlots[slotVertices[slot]] = slot;
+    }
+
+    rowOffsets.assign(numSlots + 1, 0);
+    for (int slot = 0; slot < numSlots; slot++)
+    {
+        size_t rowBits = numSlots - slot - 1;
+        rowOffsets[slot + 1] = rowOffsets[slot] + (rowBits + 63) / 64;
+    }
+    bits.assign(rowOffsets[numSlots], 0);
+}
+
+/*
+ * Record that two vertices are in line of sight of each other.
+ *
+ * @param a, b - The two vertex ids, in any order.
+ */
+template <typename T>
+void BasicVisibilityMatrix<T>::setVisible(int a, int b)
+{
+    int lower = std::min(vertexSlots[a], vertexSlots[b]);
+    int upper = std::max(vertexSlots[a], vertexSlots[b]);
+    if (lower == upper)
+    {
+        return;
+    }
+
+    size_t bit = upper - lower - 1;
+    bits[rowOffsets[lower] + bit / 64] |= 1ull << (bit % 64);
+}
+
+/*
+ * Check if two vertices are in line of sight of each other. Hull edges are stored
+ * like any other pair, so a hull edge crossing another obstacle is not visible.
+ *
+ * @param a, b - The two vertex ids, in any order.
+ *
+ * @return True if the pair was recorded with setVisible(), false otherwise.
+ */
+template <typename T>
+bool BasicVisibilityMatrix<T>::isVisible(int a, int b) const
+{
+    int lower = std::min(vertexSlots[a], vertexSlots[b]);
+    int upper = std::max(vertexSlots[a], vertexSlots[b]);
+    return lower != upper && isSet(lower, upper);
+}
+
+// Getter implementation for the number of vertices
+template <typename T>
+int BasicVisibilityMatrix<T>::getNumVertices() const
+{
+    return (int)vertexSlots.size();
+}
+
+/*
+ * Get the number of bytes used by the matrix and the slot tables.
+ *
+ * @return The size of the bits and the tables in bytes.
+ */
+template <typename T>
+size_t BasicVisibilityMatrix<T>::getMemoryUsage() const
+{
+    return bits.capacity() * sizeof(uint64_t) + rowOffsets.capacity() * sizeof(size_t) +
+        (slotVertices.capacity() + vertexSlots.capacity() + vertexPolygons.capacity()) * sizeof(int);
+}
+
+// Instantiate the matrices for both supported scalar types
+template class BasicVisibilityMatrix<float>;
+template class BasicVisibilityMatrix<double>;
@@ -0,0 +1,141 @@
+#pragma once
+#include "Point.h"
+#include "GeometryStore.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+ * Line of sight graph as a bit-packed symmetric matrix, for small and medium maps.
+ *
+ * Line of sight is symmetric, so each unordered pair of vertices is tested once and
+ * stored as one bit of the upper triangle. Edge lengths are not stored: they are
+ * computed from the store when the neighbors of a vertex are visited. Hull edges are
+ * bits too, since a hull edge may cross another obstacle. The matrix takes n * n / 16
+ * bytes for n vertices, where the adjacency arrays take 12 to 16 bytes per edge in
+ * each direction.
+ *
+ * Rows are indexed by slot: the start point first, then the vertices of the polygons
+ * in store order, then the end point. After a Hilbert reorder, polygons that are close
+ * on the map have close rows and a row scan visits nearby polygons together. Scanning
+ * the slots in order visits the neighbors in the same order as the adjacency arrays,
+ * and no vertex has an edge to the start point.
+ */
+template <typename T>
+class BasicVisibilityMatrix {
+private:
+    // The store holding the vertices
+    const BasicGeometryStore<T>* store;
+
+    // Vertex id at each slot and slot of each vertex id
+    std::vector<int> slotVertices, vertexSlots;
+
+    // Polygon of each vertex id, -1 for the start and end points
+    std::vector<int> vertexPolygons;
+
+    // First 64 bit word of each row, a row holds the slots after its own
+    std::vector<size_t> rowOffsets;
+
+    // One bit per unordered pair of slots, set if the pair can see each other
+    std::vector<uint64_t> bits;
+
+    // Check the bit of two slots, the first one smaller
+    bool isSet(int lower, int upper) const
+    {
+        size_t bit = upper - lower - 1;
+        return (bits[rowOffsets[lower] + bit / 64] >> (bit % 64)) & 1;
+    }
+
+public:
+    // Largest number of vertices the matrix is used for
+    static const int MAX_VERTICES = 16384;
+
+    // Constructor
+    BasicVisibilityMatrix();
+
+    // Lay out the slots for the vertices of a store and clear all the pairs
+    void reset(const BasicGeometryStore<T>& newStore);
+
+    // Record that two vertices are in line of sight of each other
+    void setVisible(int a, int b);
+
+    // Check if two vertices are in line of sight of each other
+    bool isVisible(int a, int b) const;
+
+    // Get the number of vertices
+    int getNumVertices() const;
+
+    // Get the number of bytes used by the matrix and the slot tables
+    size_t getMemoryUsage() const;
+
+    // Call visit(neighbor, distance) for every neighbor of a vertex
+    template <typename Visitor>
+    void forEachNeighbor(int vertex, Visitor visit) const
+    {
+        if (store->isHidden(vertex))
+        {
+            return;
+        }
+
+        BasicPoint<T> point = store->getPoint(vertex);
+        int slot = vertexSlots[vertex];
+        int polygon = vertexPolygons[vertex];
+        int ownBegin = slot, ownEnd = slot + 1;
+        if (polygon >= 0)
+        {
+            ownBegin = vertexSlots[store->getPolygonBegin(polygon)];
+            ownEnd = ownBegin + store->getPolygonEnd(polygon) - store->getPolygonBegin(polygon);
+        }
+
+        // Slots before the own polygon, stored in the rows of the other slots; slot 0 is the start point
+        for (int other = 1; other < ownBegin; other++)
+        {
+            if (isSet(other, slot))
+            {
+                int neighbor = slotVertices[other];
+                visit(neighbor, point.calculateDistance(store->getPoint(neighbor)));
+            }
+        }
+
+        // Hull neighbors, next then previous
+        if (polygon >= 0)
+        {
+            int begin = store->getPolygonBegin(polygon);
+            int end = store->getPolygonEnd(polygon);
+            int next = (vertex + 1 < end) ? vertex + 1 : begin;
+            int previous = (vertex > begin) ? vertex - 1 : end - 1;
+
+            if (isVisible(vertex, next))
+            {
+                visit(next, point.calculateDistance(store->getPoint(next)));
+            }
+
+            if (previous != next && isVisible(vertex, previous))
+            {
+                visit(previous, point.calculateDistance(store->getPoint(previous)));
+            }
+        }
+
+        // Slots after the own polygon, in the row of this slot a word at a time
+        size_t rowBits = slotVertices.size() - slot - 1;
+        size_t bit = ownEnd - slot - 1;
+        while (bit < rowBits)
+        {
+            size_t wordEnd = std::min(rowBits, (bit / 64 + 1) * 64);
+            uint64_t bitsLeft = bits[rowOffsets[slot] + bit / 64] >> (bit % 64);
+            for (; bitsLeft != 0 && bit < wordEnd; bit++, bitsLeft >>= 1)
+            {
+                if (bitsLeft & 1)
+                {
+                    int neighbor = slotVertices[slot + 1 + bit];
+                    visit(neighbor, point.calculateDistance(store->getPoint(neighbor)));
+                }
+            }
+            bit = wordEnd;
+        }
+    }
+};
+
+// A visibility matrix with the scalar type of the build
+typedef BasicVisibilityMatrix<Scalar> VisibilityMatrix;
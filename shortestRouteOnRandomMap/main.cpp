@@ -1,37 +1,208 @@
 #include "ControlManager.h"
+#include "QueryServer.h"
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+/*
+ * Parse a whole string as a non-negative decimal number.
+ *
+ * @param text - The text to parse.
+ * @param value - Set to the number if the text is valid.
+ *
+ * @return True if the text is a number that fits in a long, false otherwise.
+ */
+static bool parseNonNegative(const char* text, long& value)
+{
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < 0) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// Longest accepted --deadline-ms, one day
+static const long maxDeadlineMs = 24L * 60 * 60 * 1000;
 
 int main(int argc, const char* argv[])
 {
     // Check if a file path is provided as a command-line argument
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <file_path>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <file_path> [--engine=visibility|navmesh|grid] [--grid-resolution=N] [--smooth] [--pipelined[=workers]] [--no-reorder] [--deadline-ms=N] [--routes=K] [--no-path-file] [--report-memory] [--no-matrix] [--daemon=socket_path]" << std::endl;
         return 1; // Return an error code
     }
 
     // Get the file path from the command-line argument
     std::string filePath = argv[1];
 
+    // The time budget starts now
+    auto startTime = std::chrono::steady_clock::now();
+
     // Create a ControlManager instance
     ControlManager manager;
 
-    // Read data from the input file
-    manager.readData(filePath);
+    // Select the engine, the visibility graph is the default
+    Engine engine = Engine::VisibilityGraph;
+    int gridResolution = 512;
+    int pipelineWorkers = 0;
+    bool reorder = true;
+    int numRoutes = 0;
+    bool reportMemory = false;
+    bool useMatrix = true;
+    long deadlineMs = -1;
+    std::string socketPath;
+    for (int i = 2; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--engine=navmesh") {
+            engine = Engine::NavigationMesh;
+        }
+        else if (option == "--engine=visibility") {
+            engine = Engine::VisibilityGraph;
+        }
+        else if (option == "--engine=grid") {
+            engine = Engine::Grid;
+        }
+        else if (option.rfind("--grid-resolution=", 0) == 0 && std::atoi(option.c_str() + 18) > 0) {
+            gridResolution = std::atoi(option.c_str() + 18);
+        }
+        else if (option == "--smooth") {
+            manager.setSmoothing(true);
+        }
+        else if (option.rfind("--deadline-ms=", 0) == 0) {
+            if (!parseNonNegative(option.c_str() + 14, deadlineMs) || deadlineMs > maxDeadlineMs) {
+                std::cerr << "Invalid deadline: " << option << std::endl;
+                return 1;
+            }
+        }
+        else if (option.rfind("--routes=", 0) == 0 && std::atoi(option.c_str() + 9) > 0) {
+            numRoutes = std::atoi(option.c_str() + 9);
+        }
+        else if (option == "--no-path-file") {
+            manager.setPathFileOutput(false);
+        }
+        else if (option == "--no-matrix") {
+            useMatrix = false;
+        }
+        else if (option.rfind("--daemon=", 0) == 0 && option.size() > 9) {
+            socketPath = option.substr(9);
+        }
+        else if (option == "--report-memory") {
+            reportMemory = true;
+        }
+        else if (option == "--no-reorder") {
+            reorder = false;
+        }
+        else if (option == "--pipelined") {
+            pipelineWorkers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        else if (option.rfind("--pipelined=", 0) == 0 && std::atoi(option.c_str() + 12) > 0) {
+            pipelineWorkers = std::atoi(option.c_str() + 12);
+        }
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    manager.setEngine(engine);
+    manager.setVisibilityMatrix(useMatrix);
+
+    if (OccupancyGrid::getMaxCells(gridResolution) > OccupancyGrid::MAX_CELLS) {
+        std::cerr << "--grid-resolution is too large, the grid may not exceed " << OccupancyGrid::MAX_CELLS << " cells" << std::endl;
+        return 1;
+    }
+
+    if (numRoutes > 0 && engine != Engine::VisibilityGraph) {
+        std::cerr << "--routes requires the visibility graph engine" << std::endl;
+        return 1;
+    }
 
-    // Perform convex hull computation
-    manager.performConvexHull();
+    if (deadlineMs >= 0) {
+        // Only the single route search of the visibility graph is anytime
+        if (engine != Engine::VisibilityGraph) {
+            std::cerr << "--deadline-ms requires the visibility graph engine" << std::endl;
+            return 1;
+        }
+        if (numRoutes > 0 || !socketPath.empty()) {
+            std::cerr << "--deadline-ms cannot be combined with --routes or --daemon" << std::endl;
+            return 1;
+        }
+        manager.setDeadline(startTime + std::chrono::milliseconds(deadlineMs));
+    }
 
-    // Find points in the line of sight
-    manager.findPointslineOfSight();
+    if (!socketPath.empty()) {
+        if (engine != Engine::VisibilityGraph) {
+            std::cerr << "--daemon requires the visibility graph engine" << std::endl;
+            return 1;
+        }
 
-    // Write the results to output files
-    manager.writeData();
-    manager.writelineOfSight();
+        // Build the graph once and answer route queries until the process is stopped
+        QueryServer server(filePath, socketPath, reorder, useMatrix);
+        return server.run();
+    }
+
+    if (pipelineWorkers > 0) {
+        // Read the input file while the convex hulls are computed
+        if (!manager.readDataPipelined(filePath, pipelineWorkers)) {
+            return 1;
+        }
+    }
+    else {
+        // Read data from the input file
+        if (!manager.readData(filePath)) {
+            return 1;
+        }
 
-    // Find the shortest route
-    manager.findShortestRoute();
+        // Perform convex hull computation
+        manager.performConvexHull();
+    }
+
+    // Prune vertices that lie inside other obstacles
+    manager.pruneHiddenPoints();
+
+    if (engine == Engine::NavigationMesh) {
+        // Triangulate the free space around the obstacles
+        manager.buildNavigationMesh();
+        manager.writeData();
+    }
+    else if (engine == Engine::Grid) {
+        // Rasterise the obstacles into the occupancy grid
+        manager.buildOccupancyGrid(gridResolution);
+        manager.writeData();
+    }
+    else {
+        // Store polygons that are close on the map close in memory
+        if (reorder) {
+            manager.reorderAlongHilbertCurve();
+        }
+
+        // Find points in the line of sight
+        manager.findPointslineOfSight();
+
+        // Write the results to output files
+        manager.writeData();
+        manager.writelineOfSight();
+    }
+
+    if (numRoutes > 0) {
+        // Find alternative routes, the shortest one first
+        manager.findAlternativeRoutes(numRoutes);
+    }
+    else {
+        // Find the shortest route
+        manager.findShortestRoute();
+    }
+
+    if (reportMemory) {
+        manager.reportMemoryUsage();
+    }
 
     return 0; // Return success
 }
\ No newline at end of file